@@ -0,0 +1,266 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+// Encoding comparison: builds the formula of every buildFormula encoding for
+// a grid of board sizes, records its size, build time and memory, and solves
+// a fixed set of instances with each one. One CSV line per encoding, size and
+// instance.
+
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "board.h"
+#include "formula.h"
+#include "generator.h"
+#include "geometry.h"
+#include "satSolver.h"
+#include "templateBoard.h"
+#include "wall.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+    // forwards to a real backend and counts the literals of all clauses
+    class CountingSolver : public SatSolver
+    {
+        public:
+            CountingSolver() : m_solver(SatSolver::create()) {}
+            
+            std::string name() const override { return m_solver->name(); }
+            int newVar() override { return m_solver->newVar(); }
+            int nVars() const override { return m_solver->nVars(); }
+            int nClauses() const override { return m_solver->nClauses(); }
+            bool interrupted() const override { return m_solver->interrupted(); }
+            uint64_t conflicts() const override { return m_solver->conflicts(); }
+            void interrupt() override { m_solver->interrupt(); }
+            void clearInterrupt() override { m_solver->clearInterrupt(); }
+            bool modelValue(Lit lit) const override { return m_solver->modelValue(lit); }
+            const std::vector<Lit>& conflict() const override { return m_solver->conflict(); }
+            
+            uint64_t literals() const { return m_literals; }
+        
+        protected:
+            void add(const std::vector<Lit>& clause) override { m_literals += clause.size(); m_solver->addClause(clause); }
+            bool run(const std::vector<Lit>& assumptions) override { return m_solver->solve(assumptions); }
+        
+        private:
+            std::unique_ptr<SatSolver> m_solver;
+            uint64_t m_literals = 0;
+    };
+    
+    
+    // heap in use in kB (glibc), resident set size otherwise; the heap is not affected by memory
+    // that an earlier formula has freed, so its growth is the size of the solver's clause database
+    long memoryKilobytes()
+    {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        return static_cast<long>(mallinfo2().uordblks / 1024);
+#else
+        std::ifstream statm("/proc/self/statm");
+        long size = 0;
+        long resident = 0;
+        if (!(statm >> size >> resident))
+        {
+            return 0;
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+    }
+    
+    
+    double millisecondsSince(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    
+    struct Instance
+    {
+        std::string name;
+        std::vector<Lit> assumptions;
+    };
+    
+    
+    // the same instances for every encoding: paths through the empty board (free and corner to corner),
+    // the uniqueness proof of a generated puzzle and the search for an alternative path after opening one of its walls
+    std::vector<Instance> instances(const Board& puzzle, const Path& solution, SatSolver& s,
+        std::map<std::pair<int, int>, Lit>& fp2lit, std::map<Wall, Lit>& w2lit)
+    {
+        const int w = puzzle.width();
+        const int h = puzzle.height();
+        std::vector<Instance> result;
+        
+        std::vector<Lit> empty;
+        for (auto wl: w2lit)
+        {
+            empty.push_back(~wl.second);
+        }
+        result.push_back({"path", empty});
+        
+        std::vector<Lit> corners = empty;
+        corners.push_back(fp2lit[{0, 0}]);
+        corners.push_back(fp2lit[{w * h - 1, w * h - 1}]);
+        result.push_back({"path-corners", corners});
+        
+        // the solution is only excluded under the activation literal, so the path instances are unaffected
+        const Lit other = mkLit(s.newVar());
+        std::vector<Lit> clause{~other};
+        for (unsigned int pos = 0; pos < solution.size(); ++pos)
+        {
+            clause.push_back(~fp2lit[{c2f(solution.at(pos), w), pos}]);
+        }
+        s.addClause(clause);
+        
+        std::vector<Lit> unique{other};
+        for (auto wl: w2lit)
+        {
+            unique.push_back(puzzle.hasWall(wl.first) ? wl.second : ~wl.second);
+        }
+        result.push_back({"unique", unique});
+        
+        // the puzzle's walls are all needed for uniqueness, except for cosmetic border walls at the corners
+        for (auto opened: puzzle.walls())
+        {
+            const Coordinates& c = opened.m_coordinates;
+            const bool interior = (opened.m_orientation == Orientation::V) ? (c.x() > 0 && c.x() < w) : (c.y() > 0 && c.y() < h);
+            if (!interior)
+            {
+                continue;
+            }
+            std::vector<Lit> alternative{other};
+            for (auto wl: w2lit)
+            {
+                alternative.push_back((puzzle.hasWall(wl.first) && !(wl.first == opened)) ? wl.second : ~wl.second);
+            }
+            result.push_back({"alternative", alternative});
+            break;
+        }
+        return result;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "Display this help message")
+        ("min", po::value<int>()->default_value(4), "Smallest board side")
+        ("max", po::value<int>()->default_value(7), "Largest board side")
+        ("seed", po::value<unsigned int>()->default_value(1), "Seed of the generated puzzles")
+        ("csv", po::value<std::string>()->default_value("encodings.csv"), "Output file")
+    ;
+    
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << "\n\n" << "Usage: " << argv[0] << " [OPTIONS]...\n" << desc << std::endl;
+        return 1;
+    }
+    if (vm.count("help"))
+    {
+        std::cout << "Usage: " << argv[0] << " [OPTIONS]...\n" << desc << std::endl;
+        return 0;
+    }
+    const int minSize = vm["min"].as<int>();
+    const int maxSize = vm["max"].as<int>();
+    const unsigned int seed = vm["seed"].as<unsigned int>();
+    const std::string csvFile = vm["csv"].as<std::string>();
+    if (minSize < 2 || maxSize < minSize)
+    {
+        std::cout << "Error: bad sizes (need 2 <= min <= max)" << std::endl;
+        return 1;
+    }
+    
+    std::ofstream csv(csvFile);
+    if (!csv)
+    {
+        std::cout << "Error: cannot open '" << csvFile << "' for writing" << std::endl;
+        return 1;
+    }
+    csv << "encoding,width,height,variables,clauses,literals,build_ms,memory_kb,instance,result,solve_ms,conflicts" << std::endl;
+    
+    for (int height = minSize; height <= maxSize; ++height)
+    {
+        for (int width = height; width <= maxSize; ++width)
+        {
+            // the reference puzzle comes from the default encoding, so all encodings solve the same instances
+            Generator generator(TemplateBoard(width, height), seed);
+            generator.setVerbose(false);
+            const Board puzzle = generator.get();
+            if (puzzle.width() == 0)
+            {
+                std::cout << "Error: cannot generate a " << width << "x" << height << " puzzle" << std::endl;
+                return 1;
+            }
+            
+            for (auto encoding: allEncodings())
+            {
+                const long memoryBefore = memoryKilobytes();
+                const auto buildStart = std::chrono::steady_clock::now();
+                CountingSolver s;
+                std::map<std::pair<int, int>, Lit> fp2lit;
+                std::map<Wall, Lit> w2lit;
+                buildFormula(width, height, std::vector<bool>(), s, fp2lit, w2lit, encoding);
+                const double buildMilliseconds = millisecondsSince(buildStart);
+                const long memory = memoryKilobytes() - memoryBefore;
+                const int variables = s.nVars();
+                const int clauses = s.nClauses();
+                const uint64_t literals = s.literals();
+                
+                std::cout << "Info: " << width << "x" << height << " " << toString(encoding) << ": " << variables << " variables, "
+                    << clauses << " clauses, " << literals << " literals, " << buildMilliseconds << " ms" << std::endl;
+                
+                for (const auto& instance: instances(puzzle, generator.solution(), s, fp2lit, w2lit))
+                {
+                    const uint64_t conflictsBefore = s.conflicts();
+                    const auto solveStart = std::chrono::steady_clock::now();
+                    const bool result = s.solve(instance.assumptions);
+                    const double solveMilliseconds = millisecondsSince(solveStart);
+                    
+                    csv << toString(encoding) << "," << width << "," << height << "," << variables << "," << clauses << "," << literals << ","
+                        << buildMilliseconds << "," << memory << "," << instance.name << "," << (result ? "sat" : "unsat") << ","
+                        << solveMilliseconds << "," << s.conflicts() - conflictsBefore << std::endl;
+                }
+            }
+        }
+    }
+    
+    std::cout << "Info: wrote results to '" << csvFile << "'" << std::endl;
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+// Cross-check of the frontier DP in countPaths: counts the solutions of
+// random small boards (random walls, some with holes) by brute-force depth
+// first search and compares. Exits with 1 on the first mismatch, which is
+// printed together with the board.
+
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "board.h"
+#include "pathCounter.h"
+#include "wall.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+    class BruteForce
+    {
+        public:
+            explicit BruteForce(const Board& board) :
+                m_board(board),
+                m_visited(board.width() * board.height(), false)
+            {
+            }
+            
+            // every path is found from both ends, so the result is halved
+            PathCount count()
+            {
+                m_count = 0;
+                for (int f = 0; f < static_cast<int>(m_visited.size()); ++f)
+                {
+                    const Coordinates c = m_board.coord(f);
+                    if (!m_board.isHole(c) && isEdgeOpen(c))
+                    {
+                        m_visited[f] = true;
+                        search(c, 1);
+                        m_visited[f] = false;
+                    }
+                }
+                return m_count / 2;
+            }
+        
+        private:
+            bool present(const Coordinates& c) const
+            {
+                return c.x() >= 0 && c.y() >= 0 && c.x() < m_board.width() && c.y() < m_board.height() && !m_board.isHole(c);
+            }
+            
+            // walls between c and its left, right, upper and lower neighbour
+            std::vector<std::pair<Coordinates, Wall>> sides(const Coordinates& c) const
+            {
+                return {
+                    {c.offset(-1, 0), Wall(c, Orientation::V)},
+                    {c.offset(1, 0), Wall(c.offset(1, 0), Orientation::V)},
+                    {c.offset(0, -1), Wall(c, Orientation::H)},
+                    {c.offset(0, 1), Wall(c.offset(0, 1), Orientation::H)}
+                };
+            }
+            
+            bool isEdgeOpen(const Coordinates& c) const
+            {
+                for (const auto& side: sides(c))
+                {
+                    if (!present(side.first) && !m_board.hasWall(side.second))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            
+            void search(const Coordinates& c, int length)
+            {
+                if (length == m_board.fieldCount())
+                {
+                    if (isEdgeOpen(c))
+                    {
+                        ++m_count;
+                    }
+                    return;
+                }
+                for (const auto& side: sides(c))
+                {
+                    const Coordinates& next = side.first;
+                    if (present(next) && !m_board.hasWall(side.second) && !m_visited[m_board.index(next)])
+                    {
+                        m_visited[m_board.index(next)] = true;
+                        search(next, length + 1);
+                        m_visited[m_board.index(next)] = false;
+                    }
+                }
+            }
+            
+            const Board& m_board;
+            std::vector<bool> m_visited;
+            PathCount m_count = 0;
+    };
+}
+
+
+int main(int argc, char** argv)
+{
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "Display this help message")
+        ("boards", po::value<int>()->default_value(3000), "Number of random boards")
+        ("max", po::value<int>()->default_value(5), "Largest board side")
+        ("seed", po::value<unsigned int>()->default_value(1), "Seed of the random boards")
+    ;
+    
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << "\n\n" << "Usage: " << argv[0] << " [OPTIONS]...\n" << desc << std::endl;
+        return 1;
+    }
+    if (vm.count("help"))
+    {
+        std::cout << "Usage: " << argv[0] << " [OPTIONS]...\n" << desc << std::endl;
+        return 0;
+    }
+    const int boards = vm["boards"].as<int>();
+    const int maxSize = vm["max"].as<int>();
+    if (maxSize < 2 || maxSize > 6)
+    {
+        std::cout << "Error: bad size (need 2 <= max <= 6, brute force is exponential)" << std::endl;
+        return 1;
+    }
+    
+    std::mt19937 rng(vm["seed"].as<unsigned int>());
+    std::uniform_int_distribution<int> size(2, maxSize);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    PathCount total = 0;
+    for (int i = 0; i < boards; ++i)
+    {
+        // sparse walls keep many solutions, dense ones test the rejection of blocked fragments
+        Board board(size(rng), size(rng));
+        const double wallDensity = 0.3 * unit(rng);
+        for (int w = 0; w < board.wallCount(); ++w)
+        {
+            if (unit(rng) < wallDensity)
+            {
+                board.addWall(board.wall(w));
+            }
+        }
+        if (i % 4 == 3)
+        {
+            const int fields = board.width() * board.height();
+            board.addHole(board.coord(std::uniform_int_distribution<int>(0, fields - 1)(rng)));
+        }
+        if (board.fieldCount() < 2)
+        {
+            continue;
+        }
+        
+        PathCount dp = 0;
+        if (!countPaths(board, dp))
+        {
+            std::cout << "Error: countPaths rejects a " << board.width() << "x" << board.height() << " board" << std::endl;
+            return 1;
+        }
+        const PathCount expected = BruteForce(board).count();
+        if (dp != expected)
+        {
+            std::cout << "Error: board " << i << ": countPaths=" << toString(dp) << ", brute force=" << toString(expected) << std::endl;
+            std::cout << board << std::endl;
+            return 1;
+        }
+        total += expected;
+    }
+    
+    std::cout << "Info: " << boards << " boards agree (" << toString(total) << " solutions in total)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,244 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include "backbone.h"
+#include "formula.h"
+#include "geometry.h"
+#include "path.h"
+#include "satSolver.h"
+
+
+WallBackbone computeBackbone(const TemplateBoard& templateBoard)
+{
+    WallBackbone backbone;
+    const int width = templateBoard.width();
+    const int height = templateBoard.height();
+    const int pathLength = templateBoard.fieldCount();
+    const std::unique_ptr<SatSolver> solver = SatSolver::create();
+    SatSolver& s = *solver;
+    s.setPhase("backbone");
+    
+    std::map<std::pair<int, int>, Lit> fp2lit;
+    std::map<Wall, Lit> w2lit;
+    buildFormula(width, height, templateBoard.getHoles(), s, fp2lit, w2lit);
+    for (auto wall: templateBoard.getFixedClosedWalls())
+    {
+        s.addClause(w2lit[wall]);
+    }
+    for (auto wall: templateBoard.getFixedOpenWalls())
+    {
+        s.addClause(~w2lit[wall]);
+    }
+    
+    // closing a wall only removes paths, so the possible walls can stay unassigned: a path of any model is
+    // also a path of the template with all possible walls open
+    const std::vector<Wall> walls(templateBoard.getPossibleWalls().begin(), templateBoard.getPossibleWalls().end());
+    std::vector<bool> crossed(walls.size(), false);
+    std::vector<bool> avoided(walls.size(), false);
+    auto solve = [&](const std::vector<Lit>& assumptions)
+    {
+        ++backbone.solveCalls;
+        if (!s.solve(assumptions))
+        {
+            return false;
+        }
+        Path path(pathLength);
+        for (const auto& fp: fp2lit)
+        {
+            if (s.modelValue(fp.second))
+            {
+                path.set(fp.first.second, f2c(fp.first.first, width));
+            }
+        }
+        for (std::size_t i = 0; i < walls.size(); ++i)
+        {
+            if (path.isBlockedBy(walls[i]))
+            {
+                crossed[i] = true;
+            }
+            else
+            {
+                avoided[i] = true;
+            }
+        }
+        return true;
+    };
+    
+    if (!solve({}))
+    {
+        // no path at all, which the generator reports on its own
+        return backbone;
+    }
+    
+    auto present = [&templateBoard](const Coordinates& c)
+    {
+        return c.x() >= 0 && c.y() >= 0 && c.x() < templateBoard.width() && c.y() < templateBoard.height() && !templateBoard.isHole(c);
+    };
+    for (std::size_t i = 0; i < walls.size(); ++i)
+    {
+        const Wall& wall = walls[i];
+        if (!avoided[i])
+        {
+            // every path so far crosses the wall; if it cannot be closed at all, it is forced open
+            if (!solve({w2lit[wall]}))
+            {
+                backbone.alwaysCrossed.push_back(wall);
+                s.addClause(~w2lit[wall]);
+            }
+        }
+        else if (!crossed[i])
+        {
+            // no path so far crosses the wall; look for one that does, switched on by an activation literal
+            const Lit activation = mkLit(s.newVar());
+            std::vector<Lit> crossing = {~activation};
+            const Coordinates& c = wall.m_coordinates;
+            const Coordinates before = (wall.m_orientation == Orientation::V) ? c.offset(-1, 0) : c.offset(0, -1);
+            if (present(before) && present(c))
+            {
+                // step from field1 at p to field2 at p+1 or the other way round
+                const int field1 = c2f(before, width);
+                const int field2 = c2f(c, width);
+                for (int p = 0; p+1 < pathLength; ++p)
+                {
+                    for (auto step: {std::make_pair(field1, field2), std::make_pair(field2, field1)})
+                    {
+                        const Lit stepLit = mkLit(s.newVar());
+                        s.addClause(~stepLit, fp2lit[{step.first, p}]);
+                        s.addClause(~stepLit, fp2lit[{step.second, p+1}]);
+                        crossing.push_back(stepLit);
+                    }
+                }
+            }
+            else
+            {
+                // border wall: the edge field is entry or exit
+                const int field = c2f(present(c) ? c : before, width);
+                crossing.push_back(fp2lit[{field, 0}]);
+                crossing.push_back(fp2lit[{field, pathLength-1}]);
+            }
+            s.addClause(crossing);
+            const bool crossable = solve({activation});
+            s.addClause(~activation);
+            if (!crossable)
+            {
+                backbone.neverCrossed.push_back(wall);
+                addUncrossedWalls(width, height, templateBoard.getHoles(), {wall}, s, fp2lit);
+            }
+        }
+    }
+    
+    return backbone;
+}
+
+
+bool BackboneCache::open(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    {
+        std::ifstream file(fileName);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream is(line);
+            uint64_t hash = 0;
+            if (!(is >> std::hex >> hash >> std::dec))
+            {
+                continue;
+            }
+            WallBackbone backbone;
+            char kind = 0;
+            int x = 0;
+            int y = 0;
+            char orientation = 0;
+            bool valid = true;
+            while (is >> kind)
+            {
+                if (!(is >> x >> y >> orientation) || (kind != 'A' && kind != 'N') || (orientation != 'H' && orientation != 'V'))
+                {
+                    valid = false;
+                    break;
+                }
+                const Wall wall(Coordinates(x, y), orientation == 'H' ? Orientation::H : Orientation::V);
+                (kind == 'A' ? backbone.alwaysCrossed : backbone.neverCrossed).push_back(wall);
+            }
+            if (valid)
+            {
+                m_backbones[hash] = backbone;
+            }
+        }
+    }
+    
+    m_file.open(fileName, std::ios::app);
+    return static_cast<bool>(m_file);
+}
+
+
+bool BackboneCache::get(uint64_t templateHash, WallBackbone& backbone) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_backbones.find(templateHash);
+    if (it == m_backbones.end())
+    {
+        return false;
+    }
+    backbone = it->second;
+    return true;
+}
+
+
+void BackboneCache::add(uint64_t templateHash, const WallBackbone& backbone)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_backbones.insert({templateHash, backbone}).second)
+    {
+        return;
+    }
+    
+    if (m_file.is_open())
+    {
+        m_file << std::hex << std::setw(16) << std::setfill('0') << templateHash << std::dec;
+        auto write = [this](char kind, const std::vector<Wall>& walls)
+        {
+            for (const auto& wall: walls)
+            {
+                m_file << " " << kind << " " << wall.m_coordinates.x() << " " << wall.m_coordinates.y() << " " << (wall.m_orientation == Orientation::H ? "H" : "V");
+            }
+        };
+        write('A', backbone.alwaysCrossed);
+        write('N', backbone.neverCrossed);
+        m_file << std::endl;
+    }
+}
+
+
+std::size_t BackboneCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_backbones.size();
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "templateBoard.h"
+#include "wall.h"
+
+// Possible walls of a template whose state is the same in every solution of
+// the template with all possible walls open: a wall that every path crosses
+// can never be closed, a wall that no path crosses never changes the set of
+// solutions. Neither kind can be part of a puzzle's wall set, so the generator
+// fixes both open before it starts.
+struct WallBackbone
+{
+    std::vector<Wall> alwaysCrossed;
+    std::vector<Wall> neverCrossed;
+    unsigned int solveCalls = 0;
+};
+
+// Classifies all possible walls with one incremental solver; every path found
+// on the way settles the walls it crosses and the walls it avoids, so only the
+// remaining walls need a solve call of their own.
+WallBackbone computeBackbone(const TemplateBoard& templateBoard);
+
+
+// Backbones per template hash (see TemplateBoard::hash). Optionally backed by
+// a text file with one "hash kind x y orientation..." line per template (kind
+// A = always crossed, N = never crossed), which is loaded on open and extended
+// by every new template. All methods are thread safe.
+class BackboneCache
+{
+    public:
+        bool open(const std::string& fileName);
+        
+        bool get(uint64_t templateHash, WallBackbone& backbone) const;
+        void add(uint64_t templateHash, const WallBackbone& backbone);
+        
+        std::size_t size() const;
+    
+    private:
+        mutable std::mutex m_mutex;
+        std::map<uint64_t, WallBackbone> m_backbones;
+        std::ofstream m_file;
+};
@@ -0,0 +1,128 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bestOfGenerator.h"
+
+
+BestOfGenerator::BestOfGenerator(const TemplateBoard& templateBoard, unsigned int seed, int passes, unsigned int threads) :
+    m_template(templateBoard),
+    m_seed(seed),
+    m_passes(passes),
+    m_threads(threads)
+{
+    if (m_seed == 0)
+    {
+        m_seed = std::random_device()();
+    }
+    if (m_threads == 0)
+    {
+        m_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+
+Board BestOfGenerator::get()
+{
+    std::cout << "Info: using seed " << m_seed << ", best of " << m_passes << " passes" << std::endl;
+    const auto startTime = std::chrono::steady_clock::now();
+    m_stats = GeneratorStats();
+    m_solution = Path();
+
+    // every pass gets its own seed, so the winner can be reproduced on its own
+    std::mt19937 rng(m_seed);
+    std::vector<unsigned int> seeds;
+    for (int i = 0; i < m_passes; ++i)
+    {
+        seeds.push_back(rng() | 1);
+    }
+
+    std::atomic<int> bestWalls(INT_MAX);
+    std::atomic<int> next(0);
+    std::mutex mutex;
+    Board best;
+    int bestPass = -1;
+    auto worker = [&]()
+    {
+        for (int pass = next++; pass < m_passes; pass = next++)
+        {
+            Generator generator(m_template, seeds[pass]);
+            generator.setVerbose(false);
+            generator.setPairCache(m_pairCache);
+            generator.setLearnedClauseCache(m_learnedClauses);
+            generator.setEncoding(m_encoding);
+            generator.setBackboneCache(m_backbones);
+            generator.setWallBound(&bestWalls);
+            const Board b = generator.get();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            m_stats.solveCalls += generator.stats().solveCalls;
+            const int walls = b.walls().size();
+            if (b.width() == 0)
+            {
+                std::cout << "Info: pass " << pass + 1 << " of " << m_passes << (generator.aborted() ? ": aborted" : ": failed") << std::endl;
+            }
+            else
+            {
+                std::cout << "Info: pass " << pass + 1 << " of " << m_passes << ": walls=" << walls << std::endl;
+                if (walls < bestWalls)
+                {
+                    bestWalls = walls;
+                    bestPass = pass;
+                    best = b;
+                    m_bestSeed = generator.seed();
+                    m_solution = generator.solution();
+                }
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < std::min<unsigned int>(m_threads, m_passes); ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+
+    m_stats.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    if (bestPass < 0)
+    {
+        std::cout << "Error: no pass produced a board" << std::endl;
+        return Board();
+    }
+    std::cout << "Info: best pass " << bestPass + 1 << " (seed " << m_bestSeed << ") => walls=" << bestWalls << std::endl;
+    return best;
+}
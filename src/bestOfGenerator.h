@@ -0,0 +1,71 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include "backbone.h"
+#include "board.h"
+#include "formula.h"
+#include "generator.h"
+#include "learnedClauseCache.h"
+#include "pairCache.h"
+#include "path.h"
+#include "templateBoard.h"
+
+// Runs several independent generator passes (each with its own seed, i.e. its
+// own initial path and wall orders) in parallel and keeps the board with the
+// fewest walls. The best wall count so far is shared with the running passes,
+// which give up as soon as their certainly closed walls reach it.
+class BestOfGenerator
+{
+    public:
+      BestOfGenerator(const TemplateBoard& templateBoard, unsigned int seed, int passes, unsigned int threads);
+
+      void setPairCache(PairCache* cache) { m_pairCache = cache; }
+      // passed on to the generators of all passes (see Generator)
+      void setLearnedClauseCache(LearnedClauseCache* cache) { m_learnedClauses = cache; }
+      void setEncoding(Encoding encoding) { m_encoding = encoding; }
+      void setBackboneCache(BackboneCache* cache) { m_backbones = cache; }
+
+      Board get();
+
+      // seed of the winning pass, reproduces the board with a single Generator
+      unsigned int seed() const { return m_bestSeed; }
+      const Path& solution() const { return m_solution; }
+      const GeneratorStats& stats() const { return m_stats; }
+
+    private:
+      TemplateBoard m_template;
+      unsigned int m_seed;
+      int m_passes;
+      unsigned int m_threads;
+      PairCache* m_pairCache = nullptr;
+      LearnedClauseCache* m_learnedClauses = nullptr;
+      Encoding m_encoding = Encoding::Pairwise;
+      BackboneCache* m_backbones = nullptr;
+      unsigned int m_bestSeed = 0;
+      Path m_solution;
+      GeneratorStats m_stats;
+};
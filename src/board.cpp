@@ -22,11 +22,13 @@
 * SOFTWARE.
 *******************************************************************************/
 
-#include <core/Solver.h>
-#include <simp/SimpSolver.h>
+#include <algorithm>
+#include <sstream>
 
 #include "board.h"
+#include "deduction.h"
 #include "formula.h"
+#include "geometry.h"
 
 Board::Board(int w, int h) :
     m_width(w),
@@ -34,51 +36,95 @@ Board::Board(int w, int h) :
 {}
 
 
+void Board::addHole(const Coordinates& c)
+{
+    m_holes.resize(m_width * m_height, false);
+    m_holes[index(c)] = true;
+}
+
+
+int Board::fieldCount() const
+{
+    return m_width * m_height - static_cast<int>(std::count(m_holes.begin(), m_holes.end(), true));
+}
+
+
 std::tuple<bool, bool, Path> Board::solve() const
 {
-    SatSolver s;
-    std::map<std::pair<int, int>, Minisat::Lit> fp2lit;
-    std::map<Wall, Minisat::Lit> w2lit;
-    buildFormula(m_width, m_height, s, fp2lit, w2lit);
+    const std::unique_ptr<SatSolver> solver = SatSolver::create();
+    SatSolver& s = *solver;
+    std::map<std::pair<int, int>, Lit> fp2lit;
+    std::map<Wall, Lit> w2lit;
+    buildFormula(m_width, m_height, m_holes, s, fp2lit, w2lit);
+    
+    const int pathLength = fieldCount();
     
-    const int pathLength = m_width * m_height;
+    // the symmetry breaking stays sound for the uniqueness check below: it is
+    // only reached if the first path is symmetric itself, and then each other
+    // path still has a symmetric copy different from the first one
+    const std::vector<Transform> symmetries = this->symmetries();
+    const Lit symmetryBreaking = mkLit(s.newVar());
+    addSymmetryBreaking(m_width, m_height, m_holes, symmetries, s, fp2lit, symmetryBreaking);
     
     // assumptions: current walls
-    Minisat::vec<Minisat::Lit> wallAssumptions;
+    std::vector<Lit> wallAssumptions;
+    wallAssumptions.push_back(symmetryBreaking);
     for (auto wall = w2lit.begin(); wall != w2lit.end(); ++wall)
     {
         if (hasWall(wall->first))
         {
-            wallAssumptions.push(wall->second);
+            wallAssumptions.push_back(wall->second);
         }
         else
         {
-            wallAssumptions.push(~wall->second);
+            wallAssumptions.push_back(~wall->second);
         }
     }
     
+    // the path encoding does not see when a partial path cuts off fields; rule based deduction
+    // (with connectivity checks) excludes such steps for the walls of this board up front
+    Deduction deduction(*this);
+    if (deduction.run().contradiction)
+    {
+        return std::make_tuple(false, false, Path());
+    }
+    addUncrossedWalls(m_width, m_height, m_holes, deduction.uncrossedWalls(), s, fp2lit);
+    
+    s.setPhase("solve");
     bool satisfiable = s.solve(wallAssumptions);
     if (satisfiable)
     {
         // path found
         Path path(pathLength);
-        Minisat::vec<Minisat::Lit> pathClause;
-        for (int field = 0; field < pathLength; ++field)
+        std::vector<Lit> pathClause;
+        for (int field = 0; field < m_width * m_height; ++field)
         {
+            if (isHole(coord(field)))
+            {
+                continue;
+            }
             for (int pos = 0; pos < pathLength; ++pos)
             {
                 const auto lit = fp2lit[{field, pos}];
-                const Minisat::lbool value = s.modelValue(lit);
-                
-                if (Minisat::toInt(value) == 0 /* = Minisat::l_True */)
+                if (s.modelValue(lit))
                 {
                     path.set(pos, coord(field));
-                    pathClause.push(~lit);
+                    pathClause.push_back(~lit);
                 }
             }
         }
         
+        // a symmetric copy of an asymmetric path is a second solution
+        for (auto t: symmetries)
+        {
+            if (!path.isEquivalent(path.transformed(t, m_width, m_height)))
+            {
+                return std::make_tuple(true, false, path);
+            }
+        }
+        
         s.addClause(pathClause);
+        s.setPhase("uniqueness");
         satisfiable = s.solve(wallAssumptions);
         
         if (satisfiable)
@@ -100,6 +146,134 @@ std::tuple<bool, bool, Path> Board::solve() const
 }
 
 
+int Board::wallIndex(const Wall& w) const
+{
+    return ::wallIndex(w, m_width, m_height);
+}
+
+
+Wall Board::wall(int index) const
+{
+    const int vertical = (m_width + 1) * m_height;
+    if (index < vertical)
+    {
+        return Wall({index % (m_width + 1), index / (m_width + 1)}, Orientation::V);
+    }
+    index -= vertical;
+    return Wall({index % m_width, index / m_width}, Orientation::H);
+}
+
+
+Board Board::transformed(Transform t) const
+{
+    Board b = swapsAxes(t) ? Board(m_height, m_width) : Board(m_width, m_height);
+    for (int field = 0; field < static_cast<int>(m_holes.size()); ++field)
+    {
+        if (m_holes[field])
+        {
+            b.addHole(transform(coord(field), t, m_width, m_height));
+        }
+    }
+    for (auto wall: m_walls)
+    {
+        b.addWall(transform(wall, t, m_width, m_height));
+    }
+    return b;
+}
+
+
+std::vector<uint64_t> Board::encode() const
+{
+    // holes (if any) follow the walls
+    const int bitCount = wallCount() + (m_holes.empty() ? 0 : m_width * m_height);
+    std::vector<uint64_t> bits((bitCount + 63) / 64, 0);
+    for (auto wall: m_walls)
+    {
+        const int i = wallIndex(wall);
+        bits[i / 64] |= uint64_t(1) << (i % 64);
+    }
+    for (int field = 0; field < static_cast<int>(m_holes.size()); ++field)
+    {
+        if (m_holes[field])
+        {
+            const int i = wallCount() + field;
+            bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+    
+    // a corner field is only closed if both of its outer walls are closed,
+    // a single corner wall is decoration (see Generator::get)
+    const std::vector<std::pair<Wall, Wall>> corners{
+        {Wall({0, 0}, Orientation::V), Wall({0, 0}, Orientation::H)},
+        {Wall({m_width, 0}, Orientation::V), Wall({m_width - 1, 0}, Orientation::H)},
+        {Wall({0, m_height - 1}, Orientation::V), Wall({0, m_height}, Orientation::H)},
+        {Wall({m_width, m_height - 1}, Orientation::V), Wall({m_width - 1, m_height}, Orientation::H)}
+    };
+    for (auto corner: corners)
+    {
+        if (hasWall(corner.first) != hasWall(corner.second))
+        {
+            for (auto i: {wallIndex(corner.first), wallIndex(corner.second)})
+            {
+                bits[i / 64] &= ~(uint64_t(1) << (i % 64));
+            }
+        }
+    }
+    
+    return bits;
+}
+
+
+Board Board::canonical() const
+{
+    Board best = *this;
+    std::vector<uint64_t> bestBits = encode();
+    for (auto t: validTransforms(m_width, m_height))
+    {
+        const Board b = transformed(t);
+        const std::vector<uint64_t> bits = b.encode();
+        if (bits < bestBits)
+        {
+            best = b;
+            bestBits = bits;
+        }
+    }
+    return best;
+}
+
+
+std::vector<Transform> Board::symmetries() const
+{
+    std::vector<Transform> result;
+    const std::vector<uint64_t> bits = encode();
+    for (auto t: validTransforms(m_width, m_height))
+    {
+        if (t != Transform::Identity && transformed(t).encode() == bits)
+        {
+            result.push_back(t);
+        }
+    }
+    return result;
+}
+
+
+uint64_t Board::canonicalHash() const
+{
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ (static_cast<uint64_t>(m_width) << 32) ^ static_cast<uint64_t>(m_height);
+    for (auto word: canonical().encode())
+    {
+        // splitmix64 finalizer per word
+        h ^= word + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+
 std::string int2string(unsigned int value, unsigned int width)
 {
     std::string s;
@@ -143,6 +317,11 @@ void Board::print(std::ostream& os, const Path& path) const
             grid[gy+0][gx+dx]  = '+';
             grid[gy+dy][gx+0]  = '+';
             grid[gy+dy][gx+dx] = '+';
+            
+            if (isHole({x, y}))
+            {
+                for (int i = 1; i < dx; ++i) grid[gy + dy/2][gx+i] = '#';
+            }
         }
     }
     
@@ -180,6 +359,123 @@ void Board::print(std::ostream& os, const Path& path) const
 }
 
 
+bool Board::parse(std::istream& is, Path& path, int* line, std::string* error)
+{
+    auto nextLine = [&is, line](std::string& s)
+    {
+        if (!std::getline(is, s))
+        {
+            return false;
+        }
+        if (line) ++*line;
+        return true;
+    };
+    auto fail = [error](const std::string& reason)
+    {
+        if (error) *error = reason;
+        return false;
+    };
+    if (error) error->clear();
+    
+    // skip everything up to the next "Board WxH:" header
+    std::string s;
+    int w = 0;
+    int h = 0;
+    while (nextLine(s))
+    {
+        std::istringstream header(s);
+        std::string word;
+        char x = 0;
+        char colon = 0;
+        if (header >> word >> w >> x >> h >> colon && word == "Board" && x == 'x' && colon == ':' && w >= 2 && h >= 2)
+        {
+            break;
+        }
+        w = 0;
+        h = 0;
+    }
+    if (w == 0 || h == 0)
+    {
+        return false;
+    }
+    
+    const int dx = 4;
+    const int dy = 2;
+    std::vector<std::string> grid;
+    while (grid.size() < static_cast<unsigned int>(dy * h + 1))
+    {
+        if (!nextLine(s))
+        {
+            return fail("board ends after " + std::to_string(grid.size()) + " of " + std::to_string(dy * h + 1) + " lines");
+        }
+        s.resize(std::max<std::size_t>(s.size(), dx * w + 1), ' ');
+        grid.push_back(s);
+    }
+    
+    *this = Board(w, h);
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            if (grid[dy*y + dy/2][dx*x + dx/2] == '#') addHole({x, y});
+        }
+    }
+    for (int y = 0; y <= h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            if (grid[dy*y][dx*x + dx/2] == '-') addWall(Wall({x, y}, Orientation::H));
+        }
+    }
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x <= w; ++x)
+        {
+            if (grid[dy*y + dy/2][dx*x] == '|') addWall(Wall({x, y}, Orientation::V));
+        }
+    }
+    
+    // path positions are printed into the fields; a board without path has none
+    const int pathLength = fieldCount();
+    Path p(pathLength);
+    std::vector<bool> seen(pathLength, false);
+    int numbers = 0;
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            std::istringstream field(grid[dy*y + dy/2].substr(dx*x + 1, dx - 1));
+            int pos = -1;
+            if (!(field >> pos))
+            {
+                continue;
+            }
+            if (pos < 0 || pos >= pathLength || seen[pos])
+            {
+                return fail("bad path position " + std::to_string(pos));
+            }
+            seen[pos] = true;
+            p.set(pos, {x, y});
+            ++numbers;
+        }
+    }
+    if (numbers == pathLength)
+    {
+        path = p;
+    }
+    else if (numbers == 0)
+    {
+        path = Path();
+    }
+    else
+    {
+        return fail("path covers " + std::to_string(numbers) + " of " + std::to_string(pathLength) + " fields");
+    }
+    
+    return true;
+}
+
+
 std::ostream& operator<<(std::ostream& os, const Board& board)
 {
     board.print(os, Path());
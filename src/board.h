@@ -24,11 +24,16 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <set>
+#include <string>
 #include <tuple>
+#include <vector>
 #include "coordinates.h"
 #include "path.h"
+#include "pathCounter.h"
+#include "symmetry.h"
 #include "wall.h"
 
 
@@ -44,17 +49,45 @@ class Board
         int index(const Coordinates& c) const { return index(c.x(), c.y()); }
         Coordinates coord(int index) const { return Coordinates(index % m_width, index / m_width); }
         
+        // fields cut out of the board, one flag per field, empty if there are none
+        void addHole(const Coordinates& c);
+        bool isHole(const Coordinates& c) const { return !m_holes.empty() && m_holes[index(c)]; }
+        const std::vector<bool>& holes() const { return m_holes; }
+        // number of fields without the holes, i.e. the path length
+        int fieldCount() const;
+        
         std::tuple<bool, bool, Path> solve() const;
+        // exact number of solutions, false if the board is too wide (see countPaths)
+        bool countSolutions(PathCount& count) const { return countPaths(*this, count); }
         
         void addWall(const Wall& w) { m_walls.insert(w); }
+        void removeWall(const Wall& w) { m_walls.erase(w); }
         bool hasWall(const Wall& w) const { return m_walls.find(w) != m_walls.end(); }
+        const std::set<Wall>& walls() const { return m_walls; }
+        
+        // walls are numbered row by row, vertical walls first
+        int wallCount() const { return (m_width + 1) * m_height + m_width * (m_height + 1); }
+        int wallIndex(const Wall& w) const;
+        Wall wall(int index) const;
+        
+        Board transformed(Transform t) const;
+        Board canonical() const;
+        // non-identity transforms that leave the puzzle unchanged
+        std::vector<Transform> symmetries() const;
+        uint64_t canonicalHash() const;
         
         void print(std::ostream& os, const Path& path) const;
+        // false at the end of the input (no further "Board WxH:" header) or on a malformed board, which
+        // sets *error (cleared otherwise); *line is advanced by the number of lines read
+        bool parse(std::istream& is, Path& path, int* line = nullptr, std::string* error = nullptr);
     
     private:
+        std::vector<uint64_t> encode() const;
+        
         int m_width = 0;
         int m_height = 0;
         
+        std::vector<bool> m_holes;
         std::set<Wall> m_walls;
 };
 
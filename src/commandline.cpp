@@ -42,7 +42,27 @@ bool parseCommandLine(int argc, char** argv, Options& options)
         ("help", "Display this help message")
         ("seed", po::value<unsigned int>(), "Set random seed")
         ("solve", "Solve generated puzzle")
+        ("count", po::value<int>(), "Number of puzzles to generate")
+        ("dedup", "Drop puzzles that are rotated/mirrored copies of earlier ones")
+        ("dedup-file", po::value<std::string>(), "Persistent hash set for --dedup (implies --dedup)")
+        ("rate", "Rate the difficulty of generated puzzles by rule-based deduction")
+        ("min-difficulty", po::value<int>(), "Drop puzzles below this difficulty (0-4, implies --rate)")
         ("template", po::value<std::string>(), "Template file")
+        ("pair-cache", po::value<std::string>(), "Persistent cache of infeasible entry/exit pairs per template")
+        ("db", po::value<std::string>(), "Append generated puzzle to binary puzzle database")
+        ("convert", po::value<std::vector<std::string>>()->multitoken(), "Convert puzzles: --convert INPUT OUTPUT (ASCII <-> database)")
+        ("verify", po::value<std::vector<std::string>>()->multitoken(), "Check solvability and uniqueness of all puzzles in the given files (ASCII or database)")
+        ("edit", po::value<std::string>(), "Edit the first puzzle of an ASCII file: toggle walls given on stdin (\"V x y\", \"H x y\") and report solvability and uniqueness after each edit")
+        ("trace", po::value<std::string>(), "Write a timeline of all SAT solver calls (Chrome trace event JSON)")
+        ("threads", po::value<unsigned int>(), "Number of worker threads (default: number of CPU cores)")
+        ("best-of", po::value<int>(), "Run N generator passes in parallel (see --threads) and keep the puzzle with the fewest walls")
+        ("region-size", po::value<int>(), "Generate large boards from independent regions of about N x N fields (N >= 4)")
+        ("encoding", po::value<std::string>(), "Encoding of the at-most-one constraints: pairwise (default) or sequential")
+        ("learned-clauses", po::value<std::string>(), "Persistent cache of short learned clauses per template and encoding, preloaded into every generator")
+        ("backbone", po::value<std::string>(), "Persistent cache of the walls that every or no path of a template crosses, fixed open before generating")
+        ("cubes", po::value<unsigned int>(), "Split the uniqueness proofs into cubes by entry field, solved on N solvers in parallel")
+        ("jobs", po::value<std::string>(), "Generate all puzzles of a job manifest on a shared pool of --threads workers, longest expected first")
+        ("cost-model", po::value<std::string>(), "Persistent generation timings for the --jobs cost model")
     ;
 
     po::options_description hidden("Hidden options");
@@ -87,11 +107,156 @@ bool parseCommandLine(int argc, char** argv, Options& options)
         
         options.solve = vm.count("solve") > 0;
         
+        if (vm.count("count"))
+        {
+            options.count = vm["count"].as<int>();
+            if (options.count < 1)
+            {
+                throw std::invalid_argument("bad count (must be >= 1)");
+            }
+        }
+        
+        if (vm.count("dedup-file"))
+        {
+            options.dedupFile = vm["dedup-file"].as<std::string>();
+        }
+        options.dedup = vm.count("dedup") > 0 || !options.dedupFile.empty();
+        
+        if (vm.count("min-difficulty"))
+        {
+            options.minDifficulty = vm["min-difficulty"].as<int>();
+            if (options.minDifficulty < 0 || options.minDifficulty > 4)
+            {
+                throw std::invalid_argument("bad difficulty (must be 0-4)");
+            }
+        }
+        options.rate = vm.count("rate") > 0 || options.minDifficulty > 0;
+        
         if (vm.count("template"))
         {
             options.templateFile = vm["template"].as<std::string>();
         }
 
+        if (vm.count("pair-cache"))
+        {
+            options.pairCacheFile = vm["pair-cache"].as<std::string>();
+        }
+
+        if (vm.count("db"))
+        {
+            options.databaseFile = vm["db"].as<std::string>();
+        }
+
+        if (vm.count("encoding"))
+        {
+            const std::string name = vm["encoding"].as<std::string>();
+            bool known = false;
+            for (auto encoding: allEncodings())
+            {
+                if (toString(encoding) == name)
+                {
+                    options.encoding = encoding;
+                    known = true;
+                }
+            }
+            if (!known)
+            {
+                throw std::invalid_argument("unknown encoding '" + name + "'");
+            }
+        }
+
+        if (vm.count("learned-clauses"))
+        {
+            options.learnedClausesFile = vm["learned-clauses"].as<std::string>();
+        }
+
+        if (vm.count("backbone"))
+        {
+            options.backboneFile = vm["backbone"].as<std::string>();
+        }
+
+        if (vm.count("trace"))
+        {
+            options.traceFile = vm["trace"].as<std::string>();
+        }
+
+        if (vm.count("convert"))
+        {
+            options.convertFiles = vm["convert"].as<std::vector<std::string>>();
+            if (options.convertFiles.size() != 2)
+            {
+                throw std::invalid_argument("--convert requires an input and an output file");
+            }
+            return true;
+        }
+
+        if (vm.count("threads"))
+        {
+            options.threads = vm["threads"].as<unsigned int>();
+        }
+
+        if (vm.count("region-size"))
+        {
+            options.regionSize = vm["region-size"].as<int>();
+            if (options.regionSize < 4)
+            {
+                throw std::invalid_argument("bad region size (must be >= 4)");
+            }
+        }
+
+        if (vm.count("best-of"))
+        {
+            options.bestOf = vm["best-of"].as<int>();
+            if (options.bestOf < 1)
+            {
+                throw std::invalid_argument("bad number of passes (must be >= 1)");
+            }
+            if (options.regionSize > 0)
+            {
+                throw std::invalid_argument("--best-of cannot be combined with --region-size");
+            }
+        }
+
+        if (vm.count("cubes"))
+        {
+            options.cubeThreads = vm["cubes"].as<unsigned int>();
+            if (options.regionSize > 0 || options.bestOf > 1)
+            {
+                throw std::invalid_argument("--cubes cannot be combined with --region-size or --best-of");
+            }
+        }
+
+        if (vm.count("verify"))
+        {
+            options.verifyFiles = vm["verify"].as<std::vector<std::string>>();
+            return true;
+        }
+
+        if (vm.count("edit"))
+        {
+            options.editFile = vm["edit"].as<std::string>();
+            return true;
+        }
+
+        if (vm.count("cost-model"))
+        {
+            options.costModelFile = vm["cost-model"].as<std::string>();
+        }
+
+        if (vm.count("jobs"))
+        {
+            options.jobsFile = vm["jobs"].as<std::string>();
+            if (options.width != 0 || options.height != 0 || !options.templateFile.empty())
+            {
+                throw std::invalid_argument("--jobs cannot be combined with dimensions (WIDTH and HEIGHT) or a template file (--template)");
+            }
+            if (options.regionSize > 0 || options.bestOf > 1 || options.cubeThreads > 1)
+            {
+                throw std::invalid_argument("--jobs cannot be combined with --region-size, --best-of or --cubes");
+            }
+            return true;
+        }
+
         if ((options.width == 0 || options.height == 0) && options.templateFile.empty())
         {
             throw std::invalid_argument("either dimensions (WIDTH and HEIGHT) or a template file (--template) must be specified");
@@ -100,6 +265,10 @@ bool parseCommandLine(int argc, char** argv, Options& options)
         {
             throw std::invalid_argument("you must not specify both dimensions (WIDTH and HEIGHT) and a template file (--template)");
         }
+        if (options.regionSize > 0 && !options.templateFile.empty())
+        {
+            throw std::invalid_argument("--region-size only works with dimensions (WIDTH and HEIGHT), not with a template file");
+        }
 
         return true;
     }
@@ -25,6 +25,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include "formula.h"
 
 struct Options
 {
@@ -32,7 +34,27 @@ struct Options
     int height = 0;
     bool solve = false;
     unsigned int seed = 0;
+    int count = 1;
+    bool dedup = false;
+    bool rate = false;
+    int minDifficulty = 0;
+    std::string dedupFile;
     std::string templateFile;
+    std::string pairCacheFile;
+    std::string databaseFile;
+    std::string traceFile;
+    std::vector<std::string> convertFiles;
+    std::vector<std::string> verifyFiles;
+    std::string editFile;
+    std::string jobsFile;
+    std::string costModelFile;
+    unsigned int threads = 0;
+    int regionSize = 0;
+    int bestOf = 1;
+    unsigned int cubeThreads = 0;
+    Encoding encoding = Encoding::Pairwise;
+    std::string learnedClausesFile;
+    std::string backboneFile;
 };
 
 bool parseCommandLine(int argc, char** argv, Options& options);
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <cmath>
+#include <utility>
+
+#include "costModel.h"
+
+namespace
+{
+    // ln(1 + ms) ~ ln(fields^3 / 500): a few ms for 4x4, seconds for 8x8
+    const CostModel::Features prior{{-std::log(500.0), 3.0, 0.0, 0.0}};
+    // weight of the prior, in samples
+    const double ridge = 2.0;
+}
+
+
+CostModel::CostModel() :
+    m_coefficients(prior)
+{}
+
+
+bool CostModel::open(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    {
+        std::ifstream file(fileName);
+        Sample sample;
+        while (file >> sample.fields >> sample.walls >> sample.edges >> sample.milliseconds)
+        {
+            m_samples.push_back(sample);
+        }
+    }
+    
+    m_file.open(fileName, std::ios::app);
+    return static_cast<bool>(m_file);
+}
+
+
+CostModel::Features CostModel::features(int fields, int walls, int edges)
+{
+    return {{1.0, std::log(static_cast<double>(fields)), std::log(1.0 + walls), std::log(1.0 + edges)}};
+}
+
+
+CostModel::Features CostModel::features(const TemplateBoard& templateBoard)
+{
+    return features(templateBoard.fieldCount(), templateBoard.getPossibleWalls().size(), templateBoard.getNonBlockedEdgeFields().size());
+}
+
+
+void CostModel::fit()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // normal equations (X^T X + ridge I) b = X^T y + ridge prior
+    const int n = 4;
+    double a[n][n + 1];
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            a[i][j] = (i == j) ? ridge : 0.0;
+        }
+        a[i][n] = ridge * prior[i];
+    }
+    for (auto sample: m_samples)
+    {
+        const Features x = features(sample.fields, sample.walls, sample.edges);
+        const double y = std::log(1.0 + sample.milliseconds);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                a[i][j] += x[i] * x[j];
+            }
+            a[i][n] += x[i] * y;
+        }
+    }
+    
+    // Gaussian elimination with partial pivoting; the ridge term keeps the system regular
+    for (int col = 0; col < n; ++col)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row)
+        {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+        for (int j = 0; j <= n; ++j)
+        {
+            std::swap(a[col][j], a[pivot][j]);
+        }
+        for (int row = 0; row < n; ++row)
+        {
+            if (row == col)
+            {
+                continue;
+            }
+            const double f = a[row][col] / a[col][col];
+            for (int j = col; j <= n; ++j)
+            {
+                a[row][j] -= f * a[col][j];
+            }
+        }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        m_coefficients[i] = a[i][n] / a[i][i];
+    }
+}
+
+
+double CostModel::expectedMilliseconds(const TemplateBoard& templateBoard) const
+{
+    const Features x = features(templateBoard);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    double y = 0.0;
+    for (int i = 0; i < 4; ++i)
+    {
+        y += m_coefficients[i] * x[i];
+    }
+    return std::exp(y) - 1.0;
+}
+
+
+void CostModel::record(const TemplateBoard& templateBoard, unsigned int milliseconds)
+{
+    const Sample sample{templateBoard.fieldCount(), static_cast<int>(templateBoard.getPossibleWalls().size()),
+        static_cast<int>(templateBoard.getNonBlockedEdgeFields().size()), milliseconds};
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.push_back(sample);
+    if (m_file.is_open())
+    {
+        m_file << sample.fields << " " << sample.walls << " " << sample.edges << " " << sample.milliseconds << std::endl;
+    }
+}
+
+
+std::size_t CostModel::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.size();
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "templateBoard.h"
+
+// Expected generation time of a puzzle from features of its template: the
+// number of fields, of possible walls and of open edge fields. The model is
+// log-linear, ln(1 + ms) = b0 + b1 ln(fields) + b2 ln(1 + walls) + b3 ln(1 + edges),
+// fitted by ridge regression towards a prior that grows with fields^3, so it
+// ranks templates sensibly before any timing has been recorded.
+// Optionally backed by a text file with one "fields walls edges milliseconds"
+// line per generated puzzle, which is loaded on open and extended by every
+// record(). All methods are thread safe.
+class CostModel
+{
+    public:
+        typedef std::array<double, 4> Features;
+        
+        CostModel();
+        
+        bool open(const std::string& fileName);
+        
+        static Features features(const TemplateBoard& templateBoard);
+        
+        // refits the coefficients to all recorded timings
+        void fit();
+        double expectedMilliseconds(const TemplateBoard& templateBoard) const;
+        void record(const TemplateBoard& templateBoard, unsigned int milliseconds);
+        
+        std::size_t size() const;
+    
+    private:
+        struct Sample
+        {
+            int fields;
+            int walls;
+            int edges;
+            unsigned int milliseconds;
+        };
+        
+        static Features features(int fields, int walls, int edges);
+        
+        mutable std::mutex m_mutex;
+        std::vector<Sample> m_samples;
+        Features m_coefficients;
+        std::ofstream m_file;
+};
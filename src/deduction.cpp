@@ -0,0 +1,407 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+#include "deduction.h"
+#include "geometry.h"
+
+
+int DeductionResult::hardestTier() const
+{
+    for (int tier = deductionTiers - 1; tier >= 0; --tier)
+    {
+        if (steps[tier] > 0)
+        {
+            return tier;
+        }
+    }
+    return 0;
+}
+
+
+Deduction::Deduction(const Board& board) :
+    m_fields(board.fieldCount()),
+    m_outside(board.fieldCount()),
+    m_incident(board.fieldCount() + 1)
+{
+    const int w = board.width();
+    const int h = board.height();
+    const Geometry geometry(w, h, board.holes());
+    
+    // nodes are the fields without the holes, row by row
+    std::vector<int> node(w * h, -1);
+    for (int field = 0, next = 0; field < w * h; ++field)
+    {
+        if (!board.isHole(board.coord(field)))
+        {
+            node[field] = next++;
+        }
+    }
+    
+    std::vector<bool> closed;
+    auto addEdge = [&](int a, int b, const std::vector<Wall>& walls)
+    {
+        bool isClosed = true;
+        for (auto wall: walls)
+        {
+            isClosed = isClosed && board.hasWall(wall);
+        }
+        m_incident[a].push_back(m_edges.size());
+        m_incident[b].push_back(m_edges.size());
+        m_edges.push_back({a, b});
+        m_crossings.push_back(walls);
+        closed.push_back(isClosed);
+    };
+    
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            const int field = node[board.index(x, y)];
+            if (field == -1)
+            {
+                continue;
+            }
+            m_colour.push_back((x + y) & 1);
+            if (x + 1 < w && node[board.index(x + 1, y)] != -1)
+            {
+                addEdge(field, node[board.index(x + 1, y)], {Wall({x + 1, y}, Orientation::V)});
+            }
+            if (y + 1 < h && node[board.index(x, y + 1)] != -1)
+            {
+                addEdge(field, node[board.index(x, y + 1)], {Wall({x, y + 1}, Orientation::H)});
+            }
+            
+            // one edge to the outside per edge field (holes are outside, too); a corner is open if one of its outer walls is
+            const std::vector<Wall> border = borderWalls(geometry, board.index(x, y));
+            if (!border.empty())
+            {
+                addEdge(field, m_outside, border);
+            }
+        }
+    }
+    
+    const std::size_t words = (m_edges.size() + 63) / 64;
+    m_start.on.assign(words, 0);
+    m_start.off.assign(words, 0);
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        if (closed[edge])
+        {
+            set(m_start.off, edge);
+        }
+    }
+}
+
+
+DeductionResult Deduction::run(DeductionTier maxTier)
+{
+    DeductionResult result;
+    State state = m_start;
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        result.openEdges += isUnknown(state, edge) ? 1 : 0;
+    }
+    
+    result.contradiction = !propagate(state, maxTier, result.steps);
+    m_last = state;
+    result.decidedEdges = std::accumulate(result.steps, result.steps + deductionTiers, 0);
+    result.solved = !result.contradiction && result.decidedEdges == result.openEdges;
+    return result;
+}
+
+
+bool Deduction::propagate(State& state, DeductionTier maxTier, int* steps) const
+{
+    // restart from the simplest tier after every step
+    for (;;)
+    {
+        int decided = 0;
+        int tier = 0;
+        for (; tier <= static_cast<int>(maxTier); ++tier)
+        {
+            switch (static_cast<DeductionTier>(tier))
+            {
+                case DeductionTier::Degree: decided = applyDegree(state); break;
+                case DeductionTier::Loop:   decided = applyLoop(state); break;
+                case DeductionTier::Parity: decided = applyParity(state); break;
+                case DeductionTier::Trial:  decided = applyTrial(state); break;
+            }
+            if (decided != 0)
+            {
+                break;
+            }
+        }
+        if (decided < 0)
+        {
+            return false;
+        }
+        if (decided == 0)
+        {
+            return true;
+        }
+        if (steps)
+        {
+            steps[tier] += decided;
+        }
+    }
+}
+
+
+std::vector<Wall> Deduction::uncrossedWalls() const
+{
+    std::vector<Wall> walls;
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        if (test(m_last.off, edge) && !test(m_start.off, edge))
+        {
+            walls.insert(walls.end(), m_crossings[edge].begin(), m_crossings[edge].end());
+        }
+    }
+    return walls;
+}
+
+
+int Deduction::applyDegree(State& state) const
+{
+    int decided = 0;
+    for (int node = 0; node <= m_outside; ++node)
+    {
+        int on = 0;
+        int unknown = 0;
+        for (auto edge: m_incident[node])
+        {
+            on += test(state.on, edge) ? 1 : 0;
+            unknown += isUnknown(state, edge) ? 1 : 0;
+        }
+        if (on > 2 || on + unknown < 2)
+        {
+            return -1;
+        }
+        if (unknown == 0 || (on < 2 && on + unknown > 2))
+        {
+            continue;
+        }
+        // on == 2: all other edges are excluded; on + unknown == 2: all possible edges are used
+        for (auto edge: m_incident[node])
+        {
+            if (isUnknown(state, edge))
+            {
+                set((on == 2) ? state.off : state.on, edge);
+                ++decided;
+            }
+        }
+    }
+    return decided;
+}
+
+
+int Deduction::applyLoop(State& state) const
+{
+    // components of the used edges
+    const int nodes = m_outside + 1;
+    std::vector<int> parent(nodes);
+    std::vector<int> size(nodes, 1);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int node)
+    {
+        while (parent[node] != node)
+        {
+            node = parent[node] = parent[parent[node]];
+        }
+        return node;
+    };
+    int onEdges = 0;
+    bool closedLoop = false;
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        if (test(state.on, edge))
+        {
+            ++onEdges;
+            const int a = find(m_edges[edge].first);
+            const int b = find(m_edges[edge].second);
+            if (a == b)
+            {
+                closedLoop = true;
+                continue;
+            }
+            parent[a] = b;
+            size[b] += size[a];
+        }
+    }
+    if (closedLoop)
+    {
+        // only the final cycle through all nodes may be closed
+        return (onEdges == nodes && size[find(0)] == nodes) ? 0 : -1;
+    }
+    if (!isBiconnected(state))
+    {
+        return -1;
+    }
+    
+    int decided = 0;
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        if (isUnknown(state, edge))
+        {
+            const int a = find(m_edges[edge].first);
+            if (a == find(m_edges[edge].second) && size[a] < nodes)
+            {
+                set(state.off, edge);
+                ++decided;
+            }
+        }
+    }
+    return decided;
+}
+
+
+bool Deduction::isBiconnected(const State& state) const
+{
+    // a cycle through all nodes needs a connected graph without articulation points
+    // (iterative Tarjan: discovery time and lowpoint per node)
+    const int nodes = m_outside + 1;
+    std::vector<int> discovery(nodes, -1);
+    std::vector<int> low(nodes, 0);
+    std::vector<std::pair<int, std::size_t>> stack;  // node, next incident edge
+    std::vector<int> parentEdge(nodes, -1);
+    int time = 0;
+    int rootChildren = 0;
+    discovery[0] = low[0] = time++;
+    stack.push_back({0, 0});
+    while (!stack.empty())
+    {
+        const int node = stack.back().first;
+        std::size_t& next = stack.back().second;
+        if (next < m_incident[node].size())
+        {
+            const int edge = m_incident[node][next++];
+            if (test(state.off, edge) || edge == parentEdge[node])
+            {
+                continue;
+            }
+            const int other = (m_edges[edge].first == node) ? m_edges[edge].second : m_edges[edge].first;
+            if (discovery[other] < 0)
+            {
+                discovery[other] = low[other] = time++;
+                parentEdge[other] = edge;
+                rootChildren += (node == 0) ? 1 : 0;
+                stack.push_back({other, 0});
+            }
+            else
+            {
+                low[node] = std::min(low[node], discovery[other]);
+            }
+            continue;
+        }
+        stack.pop_back();
+        if (!stack.empty())
+        {
+            const int parent = stack.back().first;
+            low[parent] = std::min(low[parent], low[node]);
+            if (parent != 0 && low[node] >= discovery[parent])
+            {
+                return false;
+            }
+        }
+    }
+    return time == nodes && rootChildren <= 1;
+}
+
+
+int Deduction::applyParity(State& state) const
+{
+    // the path alternates colours: entry and exit have the majority colour on odd boards, different colours on even ones
+    const int black = std::accumulate(m_colour.begin(), m_colour.end(), 0);
+    const int white = m_fields - black;
+    if (std::abs(black - white) > 1)
+    {
+        // only possible with holes
+        return -1;
+    }
+    std::vector<bool> allowed(2, true);
+    if (m_fields % 2 == 1)
+    {
+        allowed[(black > white) ? 0 : 1] = false;
+    }
+    else
+    {
+        for (auto edge: m_incident[m_outside])
+        {
+            if (test(state.on, edge))
+            {
+                // the other end has the other colour
+                const int colour = m_colour[m_edges[edge].first];
+                allowed[colour] = false;
+                for (auto other: m_incident[m_outside])
+                {
+                    if (other != edge && test(state.on, other) && m_colour[m_edges[other].first] == colour)
+                    {
+                        return -1;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    
+    int decided = 0;
+    for (auto edge: m_incident[m_outside])
+    {
+        if (isUnknown(state, edge) && !allowed[m_colour[m_edges[edge].first]])
+        {
+            set(state.off, edge);
+            ++decided;
+        }
+    }
+    return decided;
+}
+
+
+int Deduction::applyTrial(State& state) const
+{
+    // one decision per call, so that the cheaper tiers continue from there
+    for (std::size_t edge = 0; edge < m_edges.size(); ++edge)
+    {
+        if (!isUnknown(state, edge))
+        {
+            continue;
+        }
+        for (auto assumeOn: {true, false})
+        {
+            State trial = state;
+            set(assumeOn ? trial.on : trial.off, edge);
+            if (!propagate(trial, DeductionTier::Parity, nullptr))
+            {
+                set(assumeOn ? state.off : state.on, edge);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
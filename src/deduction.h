@@ -0,0 +1,109 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "board.h"
+
+// Rule tiers of the deduction engine, from the simplest to the most expensive
+enum class DeductionTier
+{
+    Degree = 0,   // a field with two path edges loses all others, a field with only two possible edges uses both
+    Loop = 1,     // no edge may close a loop (or join entry and exit) before all fields are covered,
+                  // and the possible edges must keep all fields connected without a single cut field
+    Parity = 2,   // entry and exit colours on the checkerboard (same for odd boards, different for even ones)
+    Trial = 3     // an edge whose use (or omission) runs into a contradiction with the rules above
+};
+
+const int deductionTiers = 4;
+
+struct DeductionResult
+{
+    bool solved = false;
+    bool contradiction = false;
+    // edges (including the entry/exit edges through the border) that were open at the start / decided by the rules
+    int openEdges = 0;
+    int decidedEdges = 0;
+    // decided edges per tier; the hardest tier needed is the last non-zero one
+    int steps[deductionTiers] = {0, 0, 0, 0};
+    
+    int hardestTier() const;
+    // hardest tier needed, or deductionTiers if the rules do not solve the board
+    int difficulty() const { return solved ? hardestTier() : deductionTiers; }
+};
+
+// Solves a board like a human would, by local rules only (see DeductionTier),
+// always applying the lowest tier that makes progress. The path is modelled
+// as a cycle through all fields and an extra "outside" node, which is
+// connected to the edge fields through the open border walls; so every node
+// has degree 2 and entry/exit need no special cases.
+//
+// The state is a pair of bitboards (edge used / edge excluded), so the tiers
+// up to Parity take microseconds per board.
+class Deduction
+{
+    public:
+        explicit Deduction(const Board& board);
+        
+        DeductionResult run(DeductionTier maxTier = DeductionTier::Trial);
+        
+        // walls that no solution crosses according to the last run, without the closed ones
+        // (for an edge field: its border walls, i.e. it is neither entry nor exit)
+        std::vector<Wall> uncrossedWalls() const;
+    
+    private:
+        struct State
+        {
+            std::vector<uint64_t> on;
+            std::vector<uint64_t> off;
+        };
+        
+        static bool test(const std::vector<uint64_t>& bits, int edge) { return (bits[edge / 64] >> (edge % 64)) & 1; }
+        static void set(std::vector<uint64_t>& bits, int edge) { bits[edge / 64] |= uint64_t(1) << (edge % 64); }
+        bool isUnknown(const State& state, int edge) const { return !test(state.on, edge) && !test(state.off, edge); }
+        
+        // false on contradiction
+        bool propagate(State& state, DeductionTier maxTier, int* steps) const;
+        // number of edges decided, -1 on contradiction
+        int applyDegree(State& state) const;
+        int applyLoop(State& state) const;
+        int applyParity(State& state) const;
+        int applyTrial(State& state) const;
+        // the possible edges connect all nodes and no single node separates them
+        bool isBiconnected(const State& state) const;
+        
+        int m_fields;
+        int m_outside;
+        // edge endpoints (field index or m_outside) and incident edges per node
+        std::vector<std::pair<int, int>> m_edges;
+        std::vector<std::vector<int>> m_incident;
+        std::vector<int> m_colour;
+        // walls crossed by each edge (two for the outside edge of a corner)
+        std::vector<std::vector<Wall>> m_crossings;
+        State m_start;
+        State m_last;
+};
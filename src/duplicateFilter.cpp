@@ -0,0 +1,73 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include "duplicateFilter.h"
+
+bool DuplicateFilter::open(const std::string& fileName)
+{
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        unsigned char buffer[8];
+        while (file.read(reinterpret_cast<char*>(buffer), sizeof(buffer)))
+        {
+            uint64_t hash = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                hash |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+            }
+            m_hashes.insert(hash);
+        }
+    }
+
+    m_file.open(fileName, std::ios::binary | std::ios::app);
+    return static_cast<bool>(m_file);
+}
+
+
+bool DuplicateFilter::insert(const Board& board)
+{
+    return insert(board.canonicalHash());
+}
+
+
+bool DuplicateFilter::insert(uint64_t hash)
+{
+    if (!m_hashes.insert(hash).second)
+    {
+        return false;
+    }
+
+    if (m_file.is_open())
+    {
+        char buffer[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            buffer[i] = static_cast<char>((hash >> (8 * i)) & 0xff);
+        }
+        m_file.write(buffer, sizeof(buffer));
+        m_file.flush();
+    }
+    return true;
+}
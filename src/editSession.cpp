@@ -0,0 +1,372 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "deduction.h"
+#include "editSession.h"
+#include "formula.h"
+#include "geometry.h"
+
+EditSession::EditSession(const Board& board) :
+    m_board(board),
+    m_geometry(board.width(), board.height(), board.holes()),
+    m_pathLength(board.fieldCount()),
+    m_solver(SatSolver::create())
+{
+    buildFormula(m_board.width(), m_board.height(), m_board.holes(), *m_solver, m_fp2lit, m_w2lit);
+    update();
+}
+
+
+bool EditSession::setWall(const Wall& wall, bool closed)
+{
+    if (m_w2lit.find(wall) == m_w2lit.end())
+    {
+        return false;
+    }
+    m_status.solveCalls = 0;
+    if (m_board.hasWall(wall) == closed)
+    {
+        return true;
+    }
+    
+    if (closed)
+    {
+        // a new wall only removes paths: the cached ones survive unless they cross it
+        m_board.addWall(wall);
+        if (!m_alternative.isEmpty() && isBlocked(m_alternative, wall))
+        {
+            m_alternative = Path();
+            m_alternativeKnown = false;
+        }
+        if (!m_solution.isEmpty() && isBlocked(m_solution, wall))
+        {
+            // the alternative (if still valid) takes over; a unique solution leaves none
+            const bool wasUnique = m_alternativeKnown && m_alternative.isEmpty();
+            m_solution = m_alternative;
+            m_solutionKnown = !m_solution.isEmpty() || wasUnique;
+            m_alternative = Path();
+            m_alternativeKnown = wasUnique;
+        }
+    }
+    else
+    {
+        // an opened wall only adds paths: "none" and "no other one" have to be checked again,
+        // and the deduction clauses may no longer hold
+        m_board.removeWall(wall);
+        m_openedLit = crossingLiteral(wall);
+        m_solutionKnown = m_solutionKnown && !m_solution.isEmpty();
+        m_alternativeKnown = m_alternativeKnown && !m_alternative.isEmpty();
+        m_deductionValid = false;
+    }
+    
+    const auto seen = m_seen.find(wallKey());
+    if (seen != m_seen.end())
+    {
+        m_solution = seen->second.first;
+        m_alternative = seen->second.second;
+        m_solutionKnown = true;
+        m_alternativeKnown = true;
+    }
+    update();
+    return true;
+}
+
+
+bool EditSession::isBlocked(const Path& path, const Wall& wall) const
+{
+    for (unsigned int i = 0; i + 1 < path.size(); ++i)
+    {
+        if (wall.isBetween(path.at(i), path.at(i + 1)))
+        {
+            return true;
+        }
+    }
+    // unlike Path::isBlockedBy, an end field with another open border wall (e.g. a corner) is fine
+    for (auto end: {path.at(0), path.at(path.size() - 1)})
+    {
+        const std::vector<Wall> walls = borderWalls(m_geometry, m_geometry.c2f(end));
+        if (std::find(walls.begin(), walls.end(), wall) != walls.end()
+            && std::all_of(walls.begin(), walls.end(), [this](const Wall& w) { return m_board.hasWall(w); }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void EditSession::update()
+{
+    if ((!m_solutionKnown || !m_alternativeKnown) && !m_deductionValid)
+    {
+        // retire the clauses derived for an older wall set
+        if (!m_deductionLit.isUndefined())
+        {
+            m_solver->addClause(~m_deductionLit);
+            m_deductionLit = Lit();
+        }
+        Deduction deduction(m_board);
+        m_contradiction = deduction.run().contradiction;
+        if (!m_contradiction)
+        {
+            m_deductionLit = mkLit(m_solver->newVar());
+            addUncrossedWalls(m_board.width(), m_board.height(), m_board.holes(), deduction.uncrossedWalls(), *m_solver, m_fp2lit, m_deductionLit);
+        }
+        m_deductionValid = true;
+    }
+    
+    if (!m_solutionKnown)
+    {
+        m_solution = Path();
+        m_alternative = Path();
+        m_alternativeKnown = false;
+        if (!m_contradiction)
+        {
+            m_solver->setPhase("edit");
+            solve(m_openedLit.isUndefined() ? std::vector<Lit>() : std::vector<Lit>{m_openedLit}, m_solution);
+        }
+        m_solutionKnown = true;
+    }
+    
+    if (!m_alternativeKnown)
+    {
+        m_alternative = Path();
+        if (!m_solution.isEmpty())
+        {
+            // the paths before an opened wall are known (none, or just the solution), so any other one is new
+            std::vector<Lit> assumptions{blockingLiteral()};
+            if (!m_openedLit.isUndefined())
+            {
+                assumptions.push_back(m_openedLit);
+            }
+            m_solver->setPhase("edit uniqueness");
+            solve(assumptions, m_alternative);
+        }
+        m_alternativeKnown = true;
+    }
+    
+    m_openedLit = Lit();
+    m_status.solvable = !m_solution.isEmpty();
+    m_status.unique = m_status.solvable && m_alternative.isEmpty();
+    m_seen[wallKey()] = std::make_pair(m_solution, m_alternative);
+}
+
+
+std::vector<bool> EditSession::wallKey() const
+{
+    std::vector<bool> key;
+    key.reserve(m_w2lit.size());
+    for (auto wall = m_w2lit.begin(); wall != m_w2lit.end(); ++wall)
+    {
+        key.push_back(m_board.hasWall(wall->first));
+    }
+    return key;
+}
+
+
+bool EditSession::solve(const std::vector<Lit>& extraAssumptions, Path& path)
+{
+    std::vector<Lit> assumptions = extraAssumptions;
+    if (!m_deductionLit.isUndefined())
+    {
+        assumptions.push_back(m_deductionLit);
+    }
+    for (auto wall = m_w2lit.begin(); wall != m_w2lit.end(); ++wall)
+    {
+        assumptions.push_back(m_board.hasWall(wall->first) ? wall->second : ~wall->second);
+    }
+    
+    ++m_status.solveCalls;
+    if (!m_solver->solve(assumptions))
+    {
+        return false;
+    }
+    path = modelPath();
+    return true;
+}
+
+
+Path EditSession::modelPath() const
+{
+    Path path(m_pathLength);
+    for (auto fp = m_fp2lit.begin(); fp != m_fp2lit.end(); ++fp)
+    {
+        if (m_solver->modelValue(fp->second))
+        {
+            path.set(fp->first.second, m_board.coord(fp->first.first));
+        }
+    }
+    return path;
+}
+
+
+Lit EditSession::blockingLiteral()
+{
+    // one clause per solution: excludes exactly that path (in the orientation of the encoding)
+    if (!m_blockingLit.isUndefined() && m_blockedPath.isEquivalent(m_solution))
+    {
+        return m_blockingLit;
+    }
+    if (!m_blockingLit.isUndefined())
+    {
+        m_solver->addClause(~m_blockingLit);
+    }
+    m_blockingLit = mkLit(m_solver->newVar());
+    m_blockedPath = m_solution;
+    
+    std::vector<Lit> clause{~m_blockingLit};
+    for (int pos = 0; pos < m_pathLength; ++pos)
+    {
+        clause.push_back(~m_fp2lit[{c2f(m_solution.at(pos), m_board.width()), pos}]);
+    }
+    m_solver->addClause(clause);
+    return m_blockingLit;
+}
+
+
+Lit EditSession::crossingLiteral(const Wall& wall)
+{
+    const auto known = m_crossingLits.find(wall);
+    if (known != m_crossingLits.end())
+    {
+        return known->second;
+    }
+    
+    auto present = [this](const Coordinates& c)
+    {
+        return c.x() >= 0 && c.y() >= 0 && c.x() < m_board.width() && c.y() < m_board.height() && !m_board.isHole(c);
+    };
+    const Coordinates& c = wall.m_coordinates;
+    const Coordinates before = (wall.m_orientation == Orientation::V) ? c.offset(-1, 0) : c.offset(0, -1);
+    const Lit activation = mkLit(m_solver->newVar());
+    std::vector<Lit> clause{~activation};
+    if (present(before) && present(c))
+    {
+        // some step f1@p, f2@p-1 or f2@p+1
+        const int field1 = m_board.index(before);
+        const int field2 = m_board.index(c);
+        for (int p = 0; p < m_pathLength; ++p)
+        {
+            const Lit step = mkLit(m_solver->newVar());
+            m_solver->addClause(~step, m_fp2lit[{field1, p}]);
+            std::vector<Lit> neighbour{~step};
+            if (p > 0) neighbour.push_back(m_fp2lit[{field2, p-1}]);
+            if (p+1 < m_pathLength) neighbour.push_back(m_fp2lit[{field2, p+1}]);
+            m_solver->addClause(neighbour);
+            clause.push_back(step);
+        }
+    }
+    else
+    {
+        // entry or exit at the edge field
+        const int field = m_board.index(present(c) ? c : before);
+        clause.push_back(m_fp2lit[{field, 0}]);
+        clause.push_back(m_fp2lit[{field, m_pathLength-1}]);
+    }
+    m_solver->addClause(clause);
+    m_crossingLits[wall] = activation;
+    return activation;
+}
+
+
+namespace
+{
+    void printStatus(const EditStatus& status, double milliseconds)
+    {
+        std::cout << (status.unique ? "uniquely solvable" : (status.solvable ? "solvable, NOT unique" : "NOT solvable"))
+            << " (" << status.solveCalls << " solver calls, " << milliseconds << " ms)" << std::endl;
+    }
+    
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+
+bool runEditSession(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        std::cout << "Error: cannot open '" << fileName << "' for reading" << std::endl;
+        return false;
+    }
+    Board board;
+    Path path;
+    if (!board.parse(file, path))
+    {
+        std::cout << "Error: no board in '" << fileName << "'" << std::endl;
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    EditSession session(board);
+    std::cout << "Info: editing " << board.width() << "x" << board.height() << " board from '" << fileName << "': ";
+    printStatus(session.status(), millisecondsSince(start));
+    
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        std::istringstream command(line);
+        std::string word;
+        int x = 0;
+        int y = 0;
+        if (!(command >> word))
+        {
+            continue;
+        }
+        if (word == "quit")
+        {
+            break;
+        }
+        if (word == "print")
+        {
+            session.board().print(std::cout, session.status().unique ? session.solution() : Path());
+            continue;
+        }
+        if ((word == "V" || word == "H") && command >> x >> y)
+        {
+            const Wall wall({x, y}, word == "V" ? Orientation::V : Orientation::H);
+            start = std::chrono::steady_clock::now();
+            if (!session.toggleWall(wall))
+            {
+                std::cout << "Error: there is no wall " << word << " " << x << " " << y << std::endl;
+                continue;
+            }
+            std::cout << (session.board().hasWall(wall) ? "closed " : "opened ") << word << " " << x << " " << y << ": ";
+            printStatus(session.status(), millisecondsSince(start));
+            continue;
+        }
+        std::cout << "Error: unknown command '" << line << "'" << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "board.h"
+#include "geometry.h"
+#include "path.h"
+#include "satSolver.h"
+#include "wall.h"
+
+struct EditStatus
+{
+    bool solvable = false;
+    bool unique = false;
+    // SAT solver calls needed for this answer (0: answered from the cached paths or by deduction)
+    int solveCalls = 0;
+};
+
+// Keeps a board under single wall edits (e.g. in a puzzle editor) and answers
+// "still solvable? still unique?" after each of them. The formula is built
+// once; the walls are assumptions of one incremental solver, so learnt clauses
+// carry over from edit to edit. A solution and a second (alternative) path
+// are cached: a closed wall only removes paths, an opened wall only adds some,
+// so most edits are decided by checking whether the cached paths still cross
+// no wall, and the solver is only asked for what the cache cannot tell. The
+// answers for all wall sets seen so far are kept, so undoing an edit is free.
+// After opening a wall every path that is new has to cross it, so the solver
+// only searches among those.
+class EditSession
+{
+    public:
+        explicit EditSession(const Board& board);
+        EditSession(const EditSession&) = delete;
+        EditSession& operator=(const EditSession&) = delete;
+        
+        const Board& board() const { return m_board; }
+        const EditStatus& status() const { return m_status; }
+        // empty if the board is not solvable
+        const Path& solution() const { return m_solution; }
+        // a second solution, empty if the board is uniquely solvable (or not solvable)
+        const Path& alternative() const { return m_alternative; }
+        
+        // false (and no change) for wall positions that do not exist on the board
+        bool setWall(const Wall& wall, bool closed);
+        bool toggleWall(const Wall& wall) { return setWall(wall, !m_board.hasWall(wall)); }
+    
+    private:
+        // the path crosses the (closed) wall, or leaves its end fields through closed walls only
+        bool isBlocked(const Path& path, const Wall& wall) const;
+        void update();
+        // closed flags of all walls in the order of m_w2lit
+        std::vector<bool> wallKey() const;
+        bool solve(const std::vector<Lit>& extraAssumptions, Path& path);
+        Path modelPath() const;
+        Lit blockingLiteral();
+        // activation literal of "the path crosses the wall" (or, for a border wall, ends next to it)
+        Lit crossingLiteral(const Wall& wall);
+        
+        Board m_board;
+        Geometry m_geometry;
+        int m_pathLength = 0;
+        std::unique_ptr<SatSolver> m_solver;
+        std::map<std::pair<int, int>, Lit> m_fp2lit;
+        std::map<Wall, Lit> m_w2lit;
+        
+        // deduction clauses (see addUncrossedWalls) stay valid while no wall is opened
+        Lit m_deductionLit;
+        bool m_deductionValid = false;
+        bool m_contradiction = false;
+        
+        // clause excluding m_solution, active under m_blockingLit
+        Lit m_blockingLit;
+        Path m_blockedPath;
+        
+        std::map<Wall, Lit> m_crossingLits;
+        // the wall opened by the current edit, if the paths before it were known
+        Lit m_openedLit;
+        
+        Path m_solution;
+        bool m_solutionKnown = false;
+        Path m_alternative;
+        bool m_alternativeKnown = false;
+        EditStatus m_status;
+        
+        // solution and alternative per wall set
+        std::map<std::vector<bool>, std::pair<Path, Path>> m_seen;
+};
+
+// Loads the first puzzle of an ASCII file and reads edit commands from stdin, one per line:
+// "V x y" or "H x y" toggles that wall, "print" shows the board (with its solution if unique).
+// Prints the status after each edit.
+bool runEditSession(const std::string& fileName);
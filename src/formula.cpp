@@ -22,45 +22,43 @@
 * SOFTWARE.
 *******************************************************************************/
 
-#include <set>
+#include <algorithm>
 #include <vector>
 
-#include <core/Solver.h>
-#include <simp/SimpSolver.h>
-
 #include "coordinates.h"
 #include "formula.h"
+#include "geometry.h"
+#include "symmetry.h"
 #include "wall.h"
 
 
-int c2f(const Coordinates& c, int width)
-{
-    return c.x() + c.y() * width;
-}
-
-
-Coordinates f2c(int f, int width)
-{
-    return {f%width, f/width};
-}
-
-
-std::vector<Wall> allWalls(int width, int height)
+// walls next to at least one field of the board (walls between holes or between a hole and the outside have no variable)
+template<typename G>
+std::vector<Wall> allWalls(const G& g)
 {
+    const int width = g.width();
+    const int height = g.height();
+    auto present = [&g, width, height](int x, int y) { return x >= 0 && y >= 0 && x < width && y < height && !g.isHole(g.c2f({x, y})); };
     std::vector<Wall> walls;
 
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x <= width; ++x)
         {
-            walls.push_back(Wall({x, y}, Orientation::V));
+            if (present(x - 1, y) || present(x, y))
+            {
+                walls.push_back(Wall({x, y}, Orientation::V));
+            }
         }
     }
     for (int y = 0; y <= height; ++y)
     {
         for (int x = 0; x < width; ++x)
         {
-            walls.push_back(Wall({x, y}, Orientation::H));
+            if (present(x, y - 1) || present(x, y))
+            {
+                walls.push_back(Wall({x, y}, Orientation::H));
+            }
         }
     }
 
@@ -68,42 +66,96 @@ std::vector<Wall> allWalls(int width, int height)
 }
 
 
-std::vector<int> getEdgeFields(int width, int height)
+typedef std::vector<Lit> Clause;
+
+
+const std::vector<Encoding>& allEncodings()
 {
-    std::vector<int> edgeFields;
-    for (int x = 0; x < width; ++x)
-    {
-        edgeFields.push_back(c2f({x, 0}, width));
-        edgeFields.push_back(c2f({x, height-1}, width));
-    }
-    for (int y = 1; y < height-1; ++y)
+    static const std::vector<Encoding> encodings{Encoding::Pairwise, Encoding::Sequential};
+    return encodings;
+}
+
+
+std::string toString(Encoding encoding)
+{
+    switch (encoding)
     {
-        edgeFields.push_back(c2f({0, y}, width));
-        edgeFields.push_back(c2f({width-1, y}, width));
+        case Encoding::Pairwise: return "pairwise";
+        case Encoding::Sequential: return "sequential";
     }
-    return edgeFields;
+    return "unknown";
 }
 
 
+// at most one of the literals is true
+void addAtMostOne(SatSolver& s, const Clause& lits, Encoding encoding)
+{
+    if (encoding == Encoding::Pairwise)
+    {
+        for (auto lit1 = lits.begin(); lit1 != lits.end(); ++lit1)
+        {
+            for (auto lit2 = lit1+1; lit2 != lits.end(); ++lit2)
+            {
+                s.addClause(~*lit1, ~*lit2);
+            }
+        }
+        return;
+    }
 
-typedef Minisat::vec<Minisat::Lit> Clause;
+    // sequential counter: sum_i is true if one of lits[0..i] is true
+    if (lits.size() < 2)
+    {
+        return;
+    }
+    Lit sum = mkLit(s.newVar());
+    s.addClause(~lits[0], sum);
+    for (std::size_t i = 1; i+1 < lits.size(); ++i)
+    {
+        const Lit next = mkLit(s.newVar());
+        s.addClause(~lits[i], next);
+        s.addClause(~sum, next);
+        s.addClause(~lits[i], ~sum);
+        sum = next;
+    }
+    s.addClause(~lits.back(), ~sum);
+}
 
 
-void buildFormula(int width, int height, SatSolver& s, std::map<std::pair<int, int>, Minisat::Lit>& fp2lit, std::map<Wall, Minisat::Lit>& w2lit)
+template<typename G>
+void buildFormulaFor(const G& g, SatSolver& s, std::map<std::pair<int, int>, Lit>& fp2lit, std::map<Wall, Lit>& w2lit, Encoding encoding)
 {
-    const int pathLength = width * height;
+    const int width = g.width();
+    const int height = g.height();
+    const int pathLength = g.pathLength();
 
-    for (int field = 0; field < pathLength; ++field)
+    // holes get neither variables nor clauses
+    std::vector<int> fields;
+    for (int field = 0; field < g.fields(); ++field)
+    {
+        if (!g.isHole(field))
+        {
+            fields.push_back(field);
+        }
+    }
+
+    // clauses are built from a flat literal table, fp2lit is only filled for the caller
+    std::vector<Lit> lits(g.fields() * pathLength);
+    auto fp = [&lits, pathLength](int field, int pathpos) { return lits[field * pathLength + pathpos]; };
+    for (auto field: fields)
     {
         for (int pathpos = 0; pathpos < pathLength; ++pathpos)
         {
-            fp2lit[{field, pathpos}] = Minisat::mkLit(s.newVar());
+            lits[field * pathLength + pathpos] = mkLit(s.newVar());
+            fp2lit.emplace_hint(fp2lit.end(), std::make_pair(field, pathpos), lits[field * pathLength + pathpos]);
         }
     }
 
-    for (auto wall: allWalls(width, height))
+    // likewise the wall literals, by wall index
+    std::vector<Lit> wallLits(g.walls());
+    for (auto wall: allWalls(g))
     {
-        w2lit[wall] = Minisat::mkLit(s.newVar());
+        wallLits[wallIndex(wall, width, height)] = mkLit(s.newVar());
+        w2lit[wall] = wallLits[wallIndex(wall, width, height)];
     }
 
     /*
@@ -153,30 +205,27 @@ void buildFormula(int width, int height, SatSolver& s, std::map<std::pair<int, i
 
     // every field must appear on the path
     // (f@0 + f@1 + ... + f@P-1) for all f
-    for (int field = 0; field < pathLength; ++field)
+    for (auto field: fields)
     {
         Clause clause;
         for (int pos = 0; pos < pathLength; ++pos)
         {
-            const auto lit = fp2lit[{field, pos}];
-            clause.push(lit);
+            const auto lit = fp(field, pos);
+            clause.push_back(lit);
         }
         s.addClause(clause);
     }
 
     // every field must not appear twice on the path
     // f@i -> ~f@j for all f for all i!=j
-    for (int field = 0; field < pathLength; ++field)
+    for (auto field: fields)
     {
-        for (int pos1 = 0; pos1 < pathLength; ++pos1)
+        Clause positions;
+        for (int pos = 0; pos < pathLength; ++pos)
         {
-            for (int pos2 = pos1+1; pos2 < pathLength; ++pos2)
-            {
-                const auto lit1 = fp2lit[{field, pos1}];
-                const auto lit2 = fp2lit[{field, pos2}];
-                s.addClause(~lit1, ~lit2);
-            }
+            positions.push_back(fp(field, pos));
         }
+        addAtMostOne(s, positions, encoding);
     }
 
     // some field must be the path's ith step
@@ -184,10 +233,10 @@ void buildFormula(int width, int height, SatSolver& s, std::map<std::pair<int, i
     for (int pos = 0; pos < pathLength; ++pos)
     {
         Clause clause;
-        for (int field = 0; field < pathLength; ++field)
+        for (auto field: fields)
         {
-            const auto lit = fp2lit[{field, pos}];
-            clause.push(lit);
+            const auto lit = fp(field, pos);
+            clause.push_back(lit);
         }
         s.addClause(clause);
     }
@@ -196,218 +245,259 @@ void buildFormula(int width, int height, SatSolver& s, std::map<std::pair<int, i
     // i@p -> ~j@p for all p for all i!=j
     for (int pos = 0; pos < pathLength; ++pos)
     {
-        for (int field1 = 0; field1 < pathLength; ++field1)
+        Clause step;
+        for (auto field: fields)
         {
-            for (int field2 = field1+1; field2 < pathLength; ++field2)
-            {
-                const auto lit1 = fp2lit[{field1, pos}];
-                const auto lit2 = fp2lit[{field2, pos}];
-                s.addClause(~lit1, ~lit2);
-            }
+            step.push_back(fp(field, pos));
         }
+        addAtMostOne(s, step, encoding);
     }
 
     // consecutive path positions only between neighbours
-    std::set<Coordinates> allCoordinates;
+    // (fields in column major order)
     for (int x = 0; x < width; ++x)
     {
         for (int y = 0; y < height; ++y)
         {
-            allCoordinates.insert({x, y});
-        }
-    }
-    for (auto c: allCoordinates)
-    {
-        std::vector<Coordinates> neighbours;
-        std::set<Coordinates> nonNeighbours = allCoordinates;
-        nonNeighbours.erase(c);
-        if (c.x() > 0)          { neighbours.push_back(c.offset(-1,0)); nonNeighbours.erase(c.offset(-1,0)); }
-        if (c.x() + 1 < width)  { neighbours.push_back(c.offset(+1,0)); nonNeighbours.erase(c.offset(+1,0)); }
-        if (c.y() > 0)          { neighbours.push_back(c.offset(0,-1)); nonNeighbours.erase(c.offset(0,-1)); }
-        if (c.y() + 1 < height) { neighbours.push_back(c.offset(0,+1)); nonNeighbours.erase(c.offset(0,+1)); }
-
-        const int field = c2f(c, width);
-        for (int p = 0; p+1 < pathLength; ++p)
-        {
-            // f@p -> fn@p+1 v fe@p+1 v fs@p+1 v fw@p+1
-            Clause clause;
-            clause.push(~fp2lit[{field, p}]);
-            for (auto n: neighbours) { clause.push(fp2lit[{c2f(n, width), p+1}]); }
-            s.addClause(clause);
-
-            // f@p+1 -> fn@p v fe@p v fs@p v fw@p
-            Clause clause2;
-            clause2.push(~fp2lit[{field, p+1}]);
-            for (auto n: neighbours) { clause2.push(fp2lit[{c2f(n, width), p}]); }
-            s.addClause(clause2);
-
-            // f@p -> ~g@p for all non-neighbours g of f
-            for (auto n: nonNeighbours)
+            const int field = g.c2f({x, y});
+            if (g.isHole(field))
+            {
+                continue;
+            }
+            const int neighbourCount = g.neighbourCount(field);
+            const int nonNeighbourCount = g.nonNeighbourCount(field);
+
+            for (int p = 0; p+1 < pathLength; ++p)
             {
-                s.addClause(~fp2lit[{field, p}], ~fp2lit[{c2f(n, width), p+1}]);
+                // f@p -> fn@p+1 v fe@p+1 v fs@p+1 v fw@p+1
+                Clause clause;
+                clause.push_back(~fp(field, p));
+                for (int i = 0; i < neighbourCount; ++i) { clause.push_back(fp(g.neighbour(field, i), p+1)); }
+                s.addClause(clause);
+
+                // f@p+1 -> fn@p v fe@p v fs@p v fw@p
+                Clause clause2;
+                clause2.push_back(~fp(field, p+1));
+                for (int i = 0; i < neighbourCount; ++i) { clause2.push_back(fp(g.neighbour(field, i), p)); }
+                s.addClause(clause2);
+
+                // f@p -> ~g@p for all non-neighbours g of f (implied by the clause above and at most one field per step)
+                if (encoding == Encoding::Pairwise)
+                {
+                    for (int i = 0; i < nonNeighbourCount; ++i)
+                    {
+                        s.addClause(~fp(field, p), ~fp(g.nonNeighbour(field, i), p+1));
+                    }
+                }
             }
         }
     }
 
     // no consecutive path positions between fields separated by wall
     // wall(f1, f2) -> (!f1@p + !f2@p+1) <=> (!wall(f1, f2) + !f1@p + !f2@p+1)
-    for (auto c: allCoordinates)
+    for (int x = 0; x < width; ++x)
     {
-        const int field = c2f(c, width);
-        for (int p = 0; p+1 < pathLength; ++p)
+        for (int y = 0; y < height; ++y)
         {
-            const auto lit1 = fp2lit[{field, p}];
-
-            // left wall
-            if (c.x() > 0)
+            const int field = g.c2f({x, y});
+            if (g.isHole(field))
             {
-                const Wall w(c, Orientation::V);
-                const auto litw = w2lit[w];
-                const auto lit2 = fp2lit[{c2f(c.offset(-1,0), width), p+1}];
-                s.addClause(~litw, ~lit1, ~lit2);
+                continue;
             }
-
-            // right wall
-            if (c.x() + 1 < width)
-            {
-                const Wall w(c.offset(+1,0), Orientation::V);
-                const auto litw = w2lit[w];
-                const auto lit2 = fp2lit[{c2f(c.offset(+1,0), width), p+1}];
-                s.addClause(~litw, ~lit1, ~lit2);
-            }
-
-            // top wall
-            if (c.y() > 0)
+            std::vector<std::pair<Lit, int>> separated;
+            for (int i = 0; i < g.neighbourCount(field); ++i)
             {
-                const Wall w(c, Orientation::H);
-                const auto litw = w2lit[w];
-                const auto lit2 = fp2lit[{c2f(c.offset(0,-1), width), p+1}];
-                s.addClause(~litw, ~lit1, ~lit2);
+                const int n = g.neighbour(field, i);
+                separated.push_back({wallLits[g.neighbourWall(field, i)], n});
             }
 
-            // bottom wall
-            if (c.y() + 1 < height)
+            for (int p = 0; p+1 < pathLength; ++p)
             {
-                const Wall w(c.offset(0,+1), Orientation::H);
-                const auto litw = w2lit[w];
-                const auto lit2 = fp2lit[{c2f(c.offset(0,+1), width), p+1}];
-                s.addClause(~litw, ~lit1, ~lit2);
+                const auto lit1 = fp(field, p);
+                for (auto wn: separated)
+                {
+                    s.addClause(~wn.first, ~lit1, ~fp(wn.second, p+1));
+                }
             }
         }
     }
 
     // path must start/end at edge
-    const std::vector<int> edgeFields = getEdgeFields(width, height);
-
     Clause entryClause;
     Clause exitClause;
-    for (auto field: edgeFields)
+    for (int i = 0; i < g.edgeFieldCount(); ++i)
     {
-        entryClause.push(fp2lit[{field, 0}]);
-        exitClause.push(fp2lit[{field, pathLength-1}]);
+        const int field = g.edgeField(i);
+        entryClause.push_back(fp(field, 0));
+        exitClause.push_back(fp(field, pathLength-1));
     }
     s.addClause(entryClause);
     s.addClause(exitClause);
 
     // avoid symmetry -> enforce: entry < exit
-    for (auto field1: edgeFields)
+    for (int i = 0; i < g.edgeFieldCount(); ++i)
     {
-        for (auto field2: edgeFields)
+        const int field1 = g.edgeField(i);
+        for (int j = 0; j < g.edgeFieldCount(); ++j)
         {
+            const int field2 = g.edgeField(j);
             if (field2 < field1)
             {
-                const auto lit1 = fp2lit[{field1, 0}];
-                const auto lit2 = fp2lit[{field2, pathLength-1}];
+                const auto lit1 = fp(field1, 0);
+                const auto lit2 = fp(field2, pathLength-1);
                 s.addClause(~lit1, ~lit2);
             }
         }
     }
 
-    // walls can block entry/exit fields
-    // top/bottom edge
-    for (int x = 1; x < width-2; ++x)
+    // walls can block entry/exit fields: an edge field with all its border walls closed is neither
+    // (border rows/columns first, then the corners, then fields next to holes)
+    std::vector<int> blockable;
+    for (int x = 1; x < width-1; ++x)
     {
+        blockable.push_back(g.c2f({x, 0}));
+        blockable.push_back(g.c2f({x, height-1}));
+    }
+    for (int y = 1; y < height-1; ++y)
+    {
+        blockable.push_back(g.c2f({0, y}));
+        blockable.push_back(g.c2f({width-1, y}));
+    }
+    blockable.push_back(g.c2f({0, 0}));
+    blockable.push_back(g.c2f({width-1, 0}));
+    blockable.push_back(g.c2f({0, height-1}));
+    blockable.push_back(g.c2f({width-1, height-1}));
+    for (int y = 1; y < height-1; ++y)
+    {
+        for (int x = 1; x < width-1; ++x)
         {
-            const Wall w({x, 0}, Orientation::H);
-            const auto litw = w2lit[w];
-            const auto lit1 = fp2lit[{c2f({x, 0}, width), 0}];
-            const auto lit2 = fp2lit[{c2f({x, 0}, width), pathLength-1}];
-            s.addClause(~litw, ~lit1);
-            s.addClause(~litw, ~lit2);
-        }
-
-        {
-            const Wall w({x, height}, Orientation::H);
-            const auto litw = w2lit[w];
-            const auto lit1 = fp2lit[{c2f({x, height-1}, width), 0}];
-            const auto lit2 = fp2lit[{c2f({x, height-1}, width), pathLength-1}];
-            s.addClause(~litw, ~lit1);
-            s.addClause(~litw, ~lit2);
+            blockable.push_back(g.c2f({x, y}));
         }
     }
-    // left/right edge
-    for (int y = 1; y < height-2; ++y)
+    for (auto field: blockable)
     {
+        if (g.isHole(field))
         {
-            const Wall w({0, y}, Orientation::V);
-            const auto litw = w2lit[w];
-            const auto lit1 = fp2lit[{c2f({0, y}, width), 0}];
-            const auto lit2 = fp2lit[{c2f({0, y}, width), pathLength-1}];
-            s.addClause(~litw, ~lit1);
-            s.addClause(~litw, ~lit2);
+            continue;
         }
-
+        const std::vector<Wall> walls = borderWalls(g, field);
+        if (walls.empty())
         {
-            const Wall w({width, y}, Orientation::V);
-            const auto litw = w2lit[w];
-            const auto lit1 = fp2lit[{c2f({width-1, y}, width), 0}];
-            const auto lit2 = fp2lit[{c2f({width-1, y}, width), pathLength-1}];
-            s.addClause(~litw, ~lit1);
-            s.addClause(~litw, ~lit2);
+            continue;
         }
+        Clause entry;
+        for (auto w: walls) { entry.push_back(~wallLits[wallIndex(w, width, height)]); }
+        Clause exit = entry;
+        entry.push_back(~fp(field, 0));
+        exit.push_back(~fp(field, pathLength-1));
+        s.addClause(entry);
+        s.addClause(exit);
     }
-    // top left corner
+}
+
+
+void buildFormula(int width, int height, const std::vector<bool>& holes, SatSolver& s, std::map<std::pair<int, int>, Lit>& fp2lit, std::map<Wall, Lit>& w2lit, Encoding encoding)
+{
+    if (std::find(holes.begin(), holes.end(), true) != holes.end())
     {
-        const Wall w1({0, 0}, Orientation::V);
-        const Wall w2({0, 0}, Orientation::H);
-        const auto litw1 = w2lit[w1];
-        const auto litw2 = w2lit[w2];
-        const auto lit1 = fp2lit[{c2f({0, 0}, width), 0}];
-        const auto lit2 = fp2lit[{c2f({0, 0}, width), pathLength-1}];
-        s.addClause(~litw1, ~litw2, ~lit1);
-        s.addClause(~litw1, ~litw2, ~lit2);
+        buildFormulaFor(Geometry(width, height, holes), s, fp2lit, w2lit, encoding);
+        return;
     }
-    // top right corner
+    withGeometry(width, height, [&](const auto& g) { buildFormulaFor(g, s, fp2lit, w2lit, encoding); });
+}
+
+
+void addUncrossedWalls(int width, int height, const std::vector<bool>& holes, const std::vector<Wall>& walls, SatSolver& s, std::map<std::pair<int, int>, Lit>& fp2lit, Lit activation)
+{
+    auto add = [&s, activation](Clause clause)
     {
-        const Wall w1({width, 0}, Orientation::V);
-        const Wall w2({width-1, 0}, Orientation::H);
-        const auto litw1 = w2lit[w1];
-        const auto litw2 = w2lit[w2];
-        const auto lit1 = fp2lit[{c2f({width-1, 0}, width), 0}];
-        const auto lit2 = fp2lit[{c2f({width-1, 0}, width), pathLength-1}];
-        s.addClause(~litw1, ~litw2, ~lit1);
-        s.addClause(~litw1, ~litw2, ~lit2);
-    }
-    // bottom left corner
+        if (!activation.isUndefined())
+        {
+            clause.push_back(~activation);
+        }
+        s.addClause(clause);
+    };
+    const Geometry g(width, height, holes);
+    const int pathLength = g.pathLength();
+    auto present = [&g](const Coordinates& c) { return c.x() >= 0 && c.y() >= 0 && c.x() < g.width() && c.y() < g.height() && !g.isHole(g.c2f(c)); };
+    for (auto wall: walls)
     {
-        const Wall w1({0, height-1}, Orientation::V);
-        const Wall w2({0, height}, Orientation::H);
-        const auto litw1 = w2lit[w1];
-        const auto litw2 = w2lit[w2];
-        const auto lit1 = fp2lit[{c2f({0, height-1}, width), 0}];
-        const auto lit2 = fp2lit[{c2f({0, height-1}, width), pathLength-1}];
-        s.addClause(~litw1, ~litw2, ~lit1);
-        s.addClause(~litw1, ~litw2, ~lit2);
+        const Coordinates& c = wall.m_coordinates;
+        const Coordinates before = (wall.m_orientation == Orientation::V) ? c.offset(-1, 0) : c.offset(0, -1);
+        const bool hasBefore = present(before);
+        const bool hasAfter = present(c);
+        if (hasBefore && hasAfter)
+        {
+            // f1@p -> ~f2@p+1 and vice versa
+            const int field1 = c2f(before, width);
+            const int field2 = c2f(c, width);
+            for (int p = 0; p+1 < pathLength; ++p)
+            {
+                add({~fp2lit[{field1, p}], ~fp2lit[{field2, p+1}]});
+                add({~fp2lit[{field2, p}], ~fp2lit[{field1, p+1}]});
+            }
+        }
+        else if (hasBefore || hasAfter)
+        {
+            // border wall: the edge field is neither entry nor exit
+            const int field = c2f(hasAfter ? c : before, width);
+            add({~fp2lit[{field, 0}]});
+            add({~fp2lit[{field, pathLength-1}]});
+        }
     }
-    // bottom right corner
+}
+
+
+void addSymmetryBreaking(int width, int height, const std::vector<bool>& holes, const std::vector<Transform>& transforms, SatSolver& s, std::map<std::pair<int, int>, Lit>& fp2lit, Lit activation)
+{
+    // lex-leader constraints on the sequence of path fields: every clause below is
+    // implied by "path <= t(path)" or "path <= reverse(t(path))", so the smallest
+    // path of each symmetry class survives
+    const Geometry g(width, height, holes);
+    const int pathLength = g.pathLength();
+    const std::vector<int> edgeFields = g.edgeFields();
+    auto t = [&](int field, Transform tr) { return c2f(transform(f2c(field, width), tr, width, height), width); };
+
+    for (auto tr: transforms)
     {
-        const Wall w1({width, height-1}, Orientation::V);
-        const Wall w2({width-1, height}, Orientation::H);
-        const auto litw1 = w2lit[w1];
-        const auto litw2 = w2lit[w2];
-        const auto lit1 = fp2lit[{c2f({width-1, height-1}, width), 0}];
-        const auto lit2 = fp2lit[{c2f({width-1, height-1}, width), pathLength-1}];
-        s.addClause(~litw1, ~litw2, ~lit1);
-        s.addClause(~litw1, ~litw2, ~lit2);
+        for (auto entry: edgeFields)
+        {
+            const int tEntry = t(entry, tr);
+
+            // entry <= t(entry)
+            if (tEntry < entry)
+            {
+                s.addClause(~activation, ~fp2lit[{entry, 0}]);
+                continue;
+            }
+
+            for (auto exit: edgeFields)
+            {
+                if (exit == entry) continue;
+                const int tExit = t(exit, tr);
+
+                // entry <= t(exit)
+                if (tExit < entry)
+                {
+                    s.addClause(~activation, ~fp2lit[{entry, 0}], ~fp2lit[{exit, pathLength-1}]);
+                }
+                // both ends fixed by t => second field <= t(second field)
+                else if (tEntry == entry && tExit == exit)
+                {
+                    for (int field = 0; field < g.fields(); ++field)
+                    {
+                        if (!g.isHole(field) && t(field, tr) < field)
+                        {
+                            Clause clause;
+                            clause.push_back(~activation);
+                            clause.push_back(~fp2lit[{entry, 0}]);
+                            clause.push_back(~fp2lit[{exit, pathLength-1}]);
+                            clause.push_back(~fp2lit[{field, 1}]);
+                            s.addClause(clause);
+                        }
+                    }
+                }
+            }
+        }
     }
 }
@@ -25,11 +25,33 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <utility>
+#include <vector>
+#include "satSolver.h"
 class Wall;
-namespace Minisat { class SimpSolver; }
-namespace Minisat { class Solver; }
-namespace Minisat { class Lit; }
-typedef Minisat::SimpSolver SatSolver;
+enum class Transform;
 
-void buildFormula(int width, int height, SatSolver& s, std::map<std::pair<int, int>, Minisat::Lit>& field_pathpos2lit, std::map<Wall, Minisat::Lit>& wall2lit);
+// encoding of the at-most-one constraints (each field once on the path, one field per path position):
+// Pairwise needs no extra variables but a quadratic number of binary clauses; Sequential is Sinz' sequential
+// counter with linear size, and also drops the non-neighbour step clauses that the neighbour and
+// one-field-per-position clauses imply. Both have the same field/path position and wall variables.
+enum class Encoding
+{
+    Pairwise,
+    Sequential
+};
+
+const std::vector<Encoding>& allEncodings();
+std::string toString(Encoding encoding);
+
+// holes: one flag per field (fields cut out of the board), empty for a full rectangle
+void buildFormula(int width, int height, const std::vector<bool>& holes, SatSolver& s, std::map<std::pair<int, int>, Lit>& field_pathpos2lit, std::map<Wall, Lit>& wall2lit, Encoding encoding = Encoding::Pairwise);
+
+// excludes path steps across walls that no solution crosses (e.g. as found by Deduction), and entry/exit at edge
+// fields whose border walls are among them; only valid as long as the walls they were derived from are closed,
+// so the clauses can be made conditional on an activation literal
+void addUncrossedWalls(int width, int height, const std::vector<bool>& holes, const std::vector<Wall>& walls, SatSolver& s, std::map<std::pair<int, int>, Lit>& field_pathpos2lit, Lit activation = Lit());
+
+// symmetry breaking for transforms that map the board (including all wall constraints) onto itself
+void addSymmetryBreaking(int width, int height, const std::vector<bool>& holes, const std::vector<Transform>& transforms, SatSolver& s, std::map<std::pair<int, int>, Lit>& field_pathpos2lit, Lit activation);
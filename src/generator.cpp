@@ -22,13 +22,24 @@
 * SOFTWARE.
 *******************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 
-#include <core/Solver.h>
-#include <simp/SimpSolver.h>
-
 #include "formula.h"
 #include "generator.h"
+#include "templateCheck.h"
+
+namespace
+{
+    // learned clauses worth caching across runs
+    const int maxLearnedLength = 8;
+    const int maxLearnedLbd = 3;
+}
+
 
 
 Generator::Generator(const TemplateBoard& templateBoard, unsigned int seed) :
@@ -38,105 +49,276 @@ Generator::Generator(const TemplateBoard& templateBoard, unsigned int seed) :
     {
         seed = std::random_device()();
     }
-    std::cout << "Info: using seed " << seed << std::endl;
+    m_seed = seed;
     m_rng.seed(seed);
 }
 
 
 Board Generator::get()
 {
+    log() << "Info: using seed " << m_seed << std::endl;
+    const auto startTime = std::chrono::steady_clock::now();
+    m_stats = GeneratorStats();
+    m_hopelessPaths.clear();
+
+    // an initial path is hopeless if another path survives all walls that may be closed (it differs from the
+    // initial path only in fixed open walls); such a path is excluded from the initial path search and the
+    // generator starts over
+    Board b;
+    for (;;)
+    {
+        bool hopeless = false;
+        b = generate(hopeless);
+        if (!hopeless)
+        {
+            break;
+        }
+        if (m_hopelessPaths.size() > 100)
+        {
+            log() << "Error: cannot find an initial path with a unique solution within 100 tries. Check template!" << std::endl;
+            b = Board();
+            break;
+        }
+    }
+
+    m_stats.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    return b;
+}
+
+
+Board Generator::generate(bool& hopeless)
+{
+    m_aborted = false;
+    m_certainWalls = 0;
+    m_solution = Path();
+    m_cubes.clear();
+    m_clauseLog.clear();
+    m_cubeSolvers.clear();
+    m_cubeSolverClauses.clear();
+    m_cubed = false;
+
     if (w() < 2 || h() < 2)
     {
-        std::cout << "Error: the template board must be at least 2x2" << std::endl;
+        log() << "Error: the template board must be at least 2x2" << std::endl;
         return Board();
     }
 
     const std::vector<Coordinates> edgeFields = m_template.getNonBlockedEdgeFields();
     if (edgeFields.size() < 2)
     {
-        std::cout << "Error: the board template needs at least 2 open edge fields" << std::endl;
+        log() << "Error: the board template needs at least 2 open edge fields" << std::endl;
         return Board();
     }
     
-    const int pathLength = w() * h();
+    // cheap structural check, narrows the entry/exit candidates before any SAT solving
+    std::vector<std::pair<int, int>> endpointPairs;
+    std::string infeasibility;
+    if (!checkTemplate(m_template, endpointPairs, infeasibility))
+    {
+        log() << "Error: the board template has no solution: " << infeasibility << std::endl;
+        return Board();
+    }
     
-    SatSolver s;
+    const int pathLength = m_template.fieldCount();
+    
+    const std::unique_ptr<SatSolver> solver = SatSolver::create();
+    SatSolver& s = *solver;
     std::unordered_set<int> conflict;
     m_fp2lit.clear();
     m_w2lit.clear();
-    buildFormula(w(), h(), s, m_fp2lit, m_w2lit);
+    buildFormula(w(), h(), m_template.getHoles(), s, m_fp2lit, m_w2lit, m_encoding);
+    m_wallLits.assign(wallCount(w(), h()), Lit());
+    for (const auto& wall: m_w2lit)
+    {
+        m_wallLits[wallIndex(wall.first, w(), h())] = wall.second;
+    }
+    const int formulaVars = s.nVars();
+    const LearnedClauseCache::Key formulaKey(m_template.hash(), toString(m_encoding), s.nVars(), s.nClauses());
+    
+    log() << "Info: SAT encoding has " << s.nVars() << " variables and " << s.nClauses() << " clauses (backend: " << s.name() << ")" << std::endl;
     
-    std::cout << "Info: SAT encoding has " << s.nVars() << " variables and " << s.nClauses() << " clauses" << std::endl;
+    // with a learned clause cache, all clauses of this puzzle are guarded by an assumption; a learned clause
+    // without the guard follows from the formula alone and is valid for every later run of the template
+    m_puzzleGuard = Lit();
+    if (m_learnedClauses)
+    {
+        const std::vector<std::vector<Lit>> cached = m_learnedClauses->get(formulaKey);
+        for (const auto& clause: cached)
+        {
+            addClause(s, clause);
+        }
+        if (!cached.empty())
+        {
+            log() << "Info: preloaded " << cached.size() << " learned clauses" << std::endl;
+        }
+        // before the guard exists, so that guarded clauses need not be collected at all
+        s.keepLearnedClauses(maxLearnedLength, maxLearnedLbd);
+        m_puzzleGuard = mkLit(s.newVar());
+    }
 
-    std::cout << "Info: creating initial path" << std::flush;
+    // possible walls without the backbone, which can never be part of the puzzle
+    std::set<Wall> templatePossibleWalls = m_template.getPossibleWalls();
+    std::set<Wall> backboneWalls;
+    if (m_backbones)
+    {
+        WallBackbone backbone;
+        if (!m_backbones->get(m_template.hash(), backbone))
+        {
+            backbone = computeBackbone(m_template);
+            m_backbones->add(m_template.hash(), backbone);
+            m_stats.solveCalls += backbone.solveCalls;
+        }
+        backboneWalls.insert(backbone.alwaysCrossed.begin(), backbone.alwaysCrossed.end());
+        backboneWalls.insert(backbone.neverCrossed.begin(), backbone.neverCrossed.end());
+        for (auto wall: backboneWalls)
+        {
+            templatePossibleWalls.erase(wall);
+            addClause(s, {~w2lit(wall)});
+        }
+        log() << "Info: backbone fixes " << backbone.alwaysCrossed.size() << " always crossed and " << backbone.neverCrossed.size()
+            << " never crossed walls open, " << templatePossibleWalls.size() << " possible walls left" << std::endl;
+    }
+
+    log() << "Info: creating initial path" << std::flush;
+    s.setPhase("initial path");
     for (auto wall: m_template.getFixedClosedWalls())
     {
-        s.addClause(w2lit(wall));
+        addClause(s, {w2lit(wall)});
     }
     for (auto wall: m_template.getFixedOpenWalls())
     {
-        s.addClause(~w2lit(wall));
+        addClause(s, {~w2lit(wall)});
+    }
+
+    // the initial path only has to be some path, so symmetric copies can be excluded
+    m_symmetries = m_template.getSymmetries();
+    const Lit symmetryBreaking = mkLit(s.newVar());
+    addSymmetryBreaking(w(), h(), m_template.getHoles(), m_symmetries, s, m_fp2lit, symmetryBreaking);
+    // hopeless paths of earlier tries, excluded during the initial path search only
+    const Lit excludeHopeless = mkLit(s.newVar());
+    for (const auto& path: m_hopelessPaths)
+    {
+        std::vector<Lit> clause{~excludeHopeless};
+        for (int pos = 0; pos < pathLength; ++pos)
+        {
+            clause.push_back(~fp2lit(c2f(path.at(pos)), pos));
+        }
+        s.addClause(clause);
+    }
+    auto isCanonical = [this](int entry, int exit)
+    {
+        for (auto t: m_symmetries)
+        {
+            if (c2f(transform(f2c(entry), t, w(), h())) < entry || c2f(transform(f2c(exit), t, w(), h())) < entry)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // the pairs excluded by symmetry breaking have a symmetric copy among the remaining ones;
+    // pairs known to be infeasible from earlier runs are skipped
+    const uint64_t templateHash = m_template.hash();
+    std::vector<std::pair<int, int>> candidatePairs;
+    for (auto pair: endpointPairs)
+    {
+        if (isCanonical(pair.first, pair.second) && !(m_pairCache && m_pairCache->isInfeasible(templateHash, pair.first, pair.second)))
+        {
+            candidatePairs.push_back(pair);
+        }
     }
 
     // find initial path in empty board with random fixed entry/exit
     for (int count = 0; /**/; ++count)
     {
-        Minisat::vec<Minisat::Lit> initialAssumptions;
-       
-        // fix entry and exit
-        int field1 = -1;
-        int field2 = -1;
-        while (field1 == field2)
+        if (candidatePairs.empty())
         {
-            field1 = c2f(choice(edgeFields));
-            field2 = c2f(choice(edgeFields));
+            log() << "\nError: no entry/exit pair admits a path. Check template!" << std::endl;
+            return Board();
+        }
+        if (count > 100)
+        {
+            log() << "\nError: cannot find initial path within 100 tries. Check template!" << std::endl;
+            return Board();
         }
-        initialAssumptions.push(fp2lit(std::min(field1, field2), 0));
-        initialAssumptions.push(fp2lit(std::max(field1, field2), pathLength-1));
 
-        for (auto wall: m_template.getPossibleWalls())
+        std::vector<Lit> initialAssumptions;
+        initialAssumptions.push_back(symmetryBreaking);
+        initialAssumptions.push_back(excludeHopeless);
+       
+        // fix entry and exit
+        const std::pair<int, int> pair = takeChoice(candidatePairs);
+        const Lit entryLit = fp2lit(pair.first, 0);
+        const Lit exitLit = fp2lit(pair.second, pathLength-1);
+        initialAssumptions.push_back(entryLit);
+        initialAssumptions.push_back(exitLit);
+
+        for (auto wall: templatePossibleWalls)
         {
-            initialAssumptions.push(~w2lit(wall));
+            initialAssumptions.push_back(~w2lit(wall));
         }
 
-        if (s.solve(initialAssumptions)) break;
+        if (solve(s, initialAssumptions)) break;
 
-        if (count > 100)
+        // learn from the final conflict: if it does not need the entry (exit) literal, no pair with this exit (entry) works;
+        // generalizing is only sound if symmetry breaking was not involved, otherwise just the (canonical) pair is infeasible
+        getConflictSet(lastConflict(s), conflict);
+        int entry = pair.first;
+        int exit = pair.second;
+        if (conflict.find(toInt(~symmetryBreaking)) == conflict.end())
         {
-            std::cout << "\nError: cannot find initial path within 100 tries. Check template!" << std::endl;
-            return Board();
+            entry = (conflict.find(toInt(~entryLit)) != conflict.end()) ? entry : -1;
+            exit = (conflict.find(toInt(~exitLit)) != conflict.end()) ? exit : -1;
+        }
+        candidatePairs.erase(std::remove_if(candidatePairs.begin(), candidatePairs.end(), [entry, exit](const std::pair<int, int>& p)
+            {
+                return (entry == -1 || p.first == entry) && (exit == -1 || p.second == exit);
+            }), candidatePairs.end());
+        // a pair that only failed because of the hopeless paths still admits a path in other runs
+        if (m_pairCache && conflict.find(toInt(~excludeHopeless)) == conflict.end())
+        {
+            m_pairCache->addInfeasible(templateHash, entry, exit);
         }
     }
     
     // extract initialPath
-    Path initialPath(pathLength);
-    Minisat::vec<Minisat::Lit> pathClause;
-    for (int field = 0; field < pathLength; ++field)
+    const Path initialPath = modelPath();
+    std::vector<Lit> pathClause;
+    for (int pos = 0; pos < pathLength; ++pos)
     {
-        for (int pos = 0; pos < pathLength; ++pos)
+        pathClause.push_back(~fp2lit(c2f(initialPath.at(pos)), pos));
+    }
+    m_solution = initialPath;
+    log() << "\rInfo: initial path created                     " << std::endl;
+
+    // initialPath is forbidden, all other paths are alternatives
+    addClause(s, pathClause);
+    s.addClause(~symmetryBreaking);
+    s.addClause(~excludeHopeless);
+    
+    // from here on every solve call proves uniqueness or finds an alternative path; with cubes, the alternative
+    // paths are split by their entry field, the last cube covers entries outside the template's open edge fields
+    if (m_cubeThreads > 1)
+    {
+        std::vector<Lit> otherEntry;
+        for (auto c: edgeFields)
         {
-            const auto lit = fp2lit(field, pos);
-            const Minisat::lbool value = s.modelValue(lit);
-                
-            if (Minisat::toInt(value) == 0 /* = Minisat::l_True */)
-            {
-                initialPath.set(pos, f2c(field));
-                pathClause.push(~lit);
-            }
+            const Lit entry = fp2lit(c2f(c), 0);
+            m_cubes.push_back({entry});
+            otherEntry.push_back(~entry);
         }
+        m_cubes.push_back(otherEntry);
     }
-    std::cout << "\rInfo: initial path created                     " << std::endl;
-
-    // initialPath is forbidden
-    s.addClause(pathClause);
         
     std::set<Wall> fixedClosedWalls = m_template.getFixedClosedWalls();
     std::set<Wall> fixedOpenWalls = m_template.getFixedOpenWalls();
+    fixedOpenWalls.insert(backboneWalls.begin(), backboneWalls.end());
 
     std::vector<Wall> possibleWalls;
     {
         std::vector<Wall> nonblockingWalls;
-        for (auto w: m_template.getPossibleWalls())
+        for (auto w: templatePossibleWalls)
         {
             nonblockingWalls.push_back(w);
         }
@@ -155,163 +337,241 @@ Board Generator::get()
             if (fixedOpenWalls.find(w) == fixedOpenWalls.end())
             {
                 fixedOpenWalls.insert(w);
-                s.addClause(~w2lit(w));
+                addClause(s, {~w2lit(w)});
             }
         }
     }
     
-    // lifting possible walls
+    // lifting possible walls; if the initial path is not unique even with all of them closed, no wall set works
     {
-        Minisat::vec<Minisat::Lit> assumptions;
+        std::vector<Lit> assumptions;
         for (auto w: possibleWalls)
         {
-            assumptions.push(w2lit(w));
+            assumptions.push_back(w2lit(w));
         }
-        if (!s.solve(assumptions))
+        if (solve(s, assumptions))
+        {
+            log() << "\rInfo: initial path has an alternative that no possible wall blocks, trying another one" << std::endl;
+            m_hopelessPaths.push_back(initialPath);
+            hopeless = true;
+            return Board();
+        }
+        else
         {
-            getConflictSet(s.conflict, conflict);
+            getConflictSet(lastConflict(s), conflict);
 
             for (auto it = possibleWalls.begin(); it != possibleWalls.end(); /**/)
             {
                 const auto lit = w2lit(*it);
-                if (conflict.find(Minisat::toInt(~lit)) != conflict.end())
+                if (conflict.find(toInt(~lit)) != conflict.end())
                 {
                     ++it;
                 }
                 else
                 {
                     fixedOpenWalls.insert(*it);
-                    s.addClause(~lit);
+                    addClause(s, {~lit});
                     it = possibleWalls.erase(it);
                 }
             }
         }
     }
 
-    // iteratively add non-blocking walls until the initial path is unique (after adding *all* non-blocking walls, the initial path is guaranteed to be unique)
-    std::cout << "\rInfo: adding walls...                     " << std::flush;
+    // find the shortest unique prefix of a random wall order (after adding *all* non-blocking walls, the initial path is guaranteed to be unique);
+    // uniqueness is monotone in the prefix length, so galloping + binary search needs O(log n) instead of O(n) solver calls
+    log() << "\rInfo: adding walls...                     " << std::flush;
+    s.setPhase("add walls");
     std::vector<Wall> candidateClosedWalls;
-    while (!possibleWalls.empty())
+    if (!possibleWalls.empty())
     {
-        Minisat::vec<Minisat::Lit> assumptions;
+        std::vector<Wall> wallOrder;
+        while (!possibleWalls.empty())
+        {
+            wallOrder.push_back(takeChoice(possibleWalls));
+        }
 
-        const Wall wall = takeChoice(possibleWalls);
-        const auto lit = w2lit(wall);
-        assumptions.push(lit);
-        for (auto w: candidateClosedWalls)
+        std::unordered_set<int> prefixConflict;
+        // on an alternative path, a wall of wallOrder[length, limit) that blocks it is moved to position length,
+        // so that every longer prefix that is tested later eliminates this counterexample
+        auto isUniqueWithPrefix = [&](std::size_t length, std::size_t limit)
         {
-            assumptions.push(w2lit(w));
+            log() << "\rInfo: adding walls, trying prefix " << length << " of " << wallOrder.size() << "                     " << std::flush;
+            const std::vector<Wall> prefix(wallOrder.begin(), wallOrder.begin() + length);
+            if (hasSymmetricAlternative(prefix))
+            {
+                return false;
+            }
+
+            std::vector<Lit> assumptions;
+            for (std::size_t i = 0; i < wallOrder.size(); ++i)
+            {
+                assumptions.push_back((i < length) ? w2lit(wallOrder[i]) : ~w2lit(wallOrder[i]));
+            }
+            if (solve(s, assumptions))
+            {
+                const Path alternativePath = modelPath();
+                for (std::size_t i = length; i < limit; ++i)
+                {
+                    if (alternativePath.isBlockedBy(wallOrder[i]))
+                    {
+                        std::swap(wallOrder[length], wallOrder[i]);
+                        break;
+                    }
+                }
+                return false;
+            }
+            getConflictSet(lastConflict(s), prefixConflict);
+            return true;
+        };
+
+        // galloping: double the prefix until the path becomes unique
+        std::size_t lower = 0;
+        std::size_t upper = 1;
+        while (upper < wallOrder.size() && !isUniqueWithPrefix(upper, wallOrder.size()))
+        {
+            lower = upper;
+            upper *= 2;
         }
-        for (auto w: possibleWalls)
+        if (upper >= wallOrder.size())
         {
-            assumptions.push(~w2lit(w));
+            upper = wallOrder.size();
+            if (!isUniqueWithPrefix(upper, upper))
+            {
+                // a symmetric wall set would let the transformed initial path through, which the lifting solve has
+                // ruled out already; treated like a hopeless initial path just in case
+                log() << "\rInfo: initial path has an alternative that no possible wall blocks, trying another one" << std::endl;
+                m_hopelessPaths.push_back(initialPath);
+                hopeless = true;
+                return Board();
+            }
         }
-        
-        candidateClosedWalls.push_back(wall);
-        std::cout << "\rInfo: adding wall #" << candidateClosedWalls.size() << ", remaining " << possibleWalls.size() << "                     " << std::flush;
+        std::unordered_set<int> upperConflict = prefixConflict;
 
-        if (!s.solve(assumptions))
+        // binary search for the shortest unique prefix in (lower, upper]
+        while (upper - lower > 1)
         {
-            // initial path became unique
+            const std::size_t middle = lower + (upper - lower) / 2;
+            if (isUniqueWithPrefix(middle, upper))
+            {
+                upper = middle;
+                upperConflict = prefixConflict;
+            }
+            else
+            {
+                lower = middle;
+            }
+        }
 
-            getConflictSet(s.conflict, conflict);
-            
-            // conflict clause based lifting
-            for (auto it = candidateClosedWalls.begin(); it != candidateClosedWalls.end(); /**/)
+        // conflict clause based lifting
+        conflict = upperConflict;
+        for (std::size_t i = 0; i < upper; ++i)
+        {
+            const auto lit = w2lit(wallOrder[i]);
+            if (conflict.find(toInt(~lit)) != conflict.end())
             {
-                const auto lit = w2lit(*it);
-                if (conflict.find(Minisat::toInt(~lit)) != conflict.end())
-                {
-                    ++it;
-                }
-                else
-                {
-                    fixedOpenWalls.insert(*it);
-                    s.addClause(~lit);
-                    it = candidateClosedWalls.erase(it);
-                }
+                candidateClosedWalls.push_back(wallOrder[i]);
+            }
+            else
+            {
+                fixedOpenWalls.insert(wallOrder[i]);
+                addClause(s, {~lit});
             }
-            
-            break;
         }
     }
-    std::cout << "\rInfo: added walls => walls=" << candidateClosedWalls.size() << "                            " << std::endl;
+    log() << "\rInfo: added walls => walls=" << candidateClosedWalls.size() << "                            " << std::endl;
     
-    std::cout << "\rInfo: removing non-essential walls...                     " << std::flush;
-    while (!candidateClosedWalls.empty())
+    log() << "\rInfo: removing non-essential walls...                     " << std::flush;
+    s.setPhase("remove walls");
+    m_certainWalls = fixedClosedWalls.size();
+    if (!candidateClosedWalls.empty())
     {
-        std::cout << "\rInfo: removing walls... " << candidateClosedWalls.size() << "                     " << std::flush;
-        Minisat::vec<Minisat::Lit> assumptions;
-        
-        const Wall wall = takeChoice(candidateClosedWalls);
-        const auto lit = w2lit(wall);
-        assumptions.push(~lit);
-        for (auto w: candidateClosedWalls)
+        // random order, so that different seeds end up with different minimal wall sets
+        std::vector<Wall> candidates;
+        while (!candidateClosedWalls.empty())
         {
-            assumptions.push(w2lit(w));
+            candidates.push_back(takeChoice(candidateClosedWalls));
         }
-        
-        if (s.solve(assumptions))
+
+        std::vector<Wall> essentialWalls;
+        if (!isUnique(s, {}, conflict))
         {
-            // wall is needed to keep path unique -> fix variable=1
-            s.addClause(lit);
-            fixedClosedWalls.insert(wall);
+            essentialWalls = quickXplain(s, {}, candidates);
         }
-        else
+        if (m_aborted)
         {
-            getConflictSet(s.conflict, conflict);
+            log() << "\rInfo: aborted, cannot get below " << m_wallBound->load() << " walls                     " << std::endl;
+            return Board();
+        }
 
-            // conflict clause based lifting
-            for (auto it = candidateClosedWalls.begin(); it != candidateClosedWalls.end(); /**/)
+        const std::set<Wall> essential(essentialWalls.begin(), essentialWalls.end());
+        for (auto wall: candidates)
+        {
+            const auto lit = w2lit(wall);
+            if (essential.find(wall) != essential.end())
             {
-                const auto lit = w2lit(*it);
-                if (conflict.find(Minisat::toInt(~lit)) != conflict.end())
-                {
-                    ++it;
-                }
-                else
-                {
-                    fixedOpenWalls.insert(*it);
-                    s.addClause(~lit);
-                    it = candidateClosedWalls.erase(it);
-                }
+                // wall is needed to keep path unique -> fix variable=1
+                addClause(s, {lit});
+                fixedClosedWalls.insert(wall);
+            }
+            else
+            {
+                // wall can be removed -> fix variable=0
+                fixedOpenWalls.insert(wall);
+                addClause(s, {~lit});
             }
-
-            // wall can be removed -> fix variable=0
-            fixedOpenWalls.insert(wall);
-            s.addClause(~lit);
         }
     }
-    std::cout << "\rInfo: removed non-essential walls => walls=" << fixedClosedWalls.size() << "                     " << std::endl;
+    log() << "\rInfo: removed non-essential walls => walls=" << fixedClosedWalls.size() << "                     " << std::endl;
+    
+    if (m_learnedClauses)
+    {
+        std::vector<std::vector<Lit>> learned;
+        for (const auto& clause: s.takeLearnedClauses())
+        {
+            if (std::all_of(clause.begin(), clause.end(), [formulaVars](const Lit& lit) { return lit.var() < formulaVars; }))
+            {
+                learned.push_back(clause);
+            }
+        }
+        const std::size_t added = m_learnedClauses->add(formulaKey, learned);
+        log() << "Info: cached " << added << " new learned clauses" << std::endl;
+    }
 
     // create final board
     Board b(w(), h());
+    for (int y = 0; y < h(); ++y)
+    {
+        for (int x = 0; x < w(); ++x)
+        {
+            if (m_template.isHole({x, y})) b.addHole({x, y});
+        }
+    }
     for (auto wall: fixedClosedWalls)
     {
         b.addWall(wall);
     }   
     
-    // cosmetic fix: make sure the corners have at least one wall
+    // cosmetic fix: make sure the corners (unless cut out) have at least one wall
     // top left
-    if (!b.hasWall(Wall({0,0}, Orientation::V)) && !b.hasWall(Wall({0,0}, Orientation::H)))
+    if (!b.isHole({0,0}) && !b.hasWall(Wall({0,0}, Orientation::V)) && !b.hasWall(Wall({0,0}, Orientation::H)))
     {
         std::vector<Wall> walls{Wall({0,0}, Orientation::V), Wall({0,0}, Orientation::H)};
         b.addWall(takeChoice(walls));
     }
     // top right
-    if (!b.hasWall(Wall({w(),0}, Orientation::V)) && !b.hasWall(Wall({w()-1,0}, Orientation::H)))
+    if (!b.isHole({w()-1,0}) && !b.hasWall(Wall({w(),0}, Orientation::V)) && !b.hasWall(Wall({w()-1,0}, Orientation::H)))
     {
         std::vector<Wall> walls{Wall({w(),0}, Orientation::V), Wall({w()-1,0}, Orientation::H)};
         b.addWall(takeChoice(walls));
     }
     // bottom left
-    if (!b.hasWall(Wall({0,h()-1}, Orientation::V)) && !b.hasWall(Wall({0,h()}, Orientation::H)))
+    if (!b.isHole({0,h()-1}) && !b.hasWall(Wall({0,h()-1}, Orientation::V)) && !b.hasWall(Wall({0,h()}, Orientation::H)))
     {
         std::vector<Wall> walls{Wall({0,h()-1}, Orientation::V), Wall({0,h()}, Orientation::H)};
         b.addWall(takeChoice(walls));
     }
     // top right
-    if (!b.hasWall(Wall({w(),h()-1}, Orientation::V)) && !b.hasWall(Wall({w()-1,h()}, Orientation::H)))
+    if (!b.isHole({w()-1,h()-1}) && !b.hasWall(Wall({w(),h()-1}, Orientation::V)) && !b.hasWall(Wall({w()-1,h()}, Orientation::H)))
     {
         std::vector<Wall> walls{Wall({w(),h()-1}, Orientation::V), Wall({w()-1,h()}, Orientation::H)};
         b.addWall(takeChoice(walls));
@@ -320,10 +580,273 @@ Board Generator::get()
     return b;
 }
 
-void Generator::getConflictSet(const Minisat::vec<Minisat::Lit>& conflictVec, std::unordered_set<int>& conflictSet) const
+
+Path Generator::modelPath() const
+{
+    const int pathLength = m_template.fieldCount();
+    Path path(pathLength);
+    for (int field = 0; field < w() * h(); ++field)
+    {
+        if (m_template.isHole(f2c(field)))
+        {
+            continue;
+        }
+        for (int pos = 0; pos < pathLength; ++pos)
+        {
+            if (m_modelSolver->modelValue(fp2lit(field, pos)))
+            {
+                path.set(pos, f2c(field));
+            }
+        }
+    }
+    return path;
+}
+
+
+bool Generator::hasSymmetricAlternative(const std::vector<Wall>& closedWalls) const
+{
+    // the template's closed walls are symmetric anyway, open walls do not matter
+    const std::set<Wall> closed(closedWalls.begin(), closedWalls.end());
+    for (auto t: m_symmetries)
+    {
+        if (m_solution.isEquivalent(m_solution.transformed(t, w(), h())))
+        {
+            continue;
+        }
+
+        bool symmetric = true;
+        for (auto wall: closed)
+        {
+            if (closed.find(transform(wall, t, w(), h())) == closed.end())
+            {
+                symmetric = false;
+                break;
+            }
+        }
+        if (symmetric)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+std::vector<Wall> Generator::quickXplain(SatSolver& s, const std::vector<Wall>& background, const std::vector<Wall>& candidates)
+{
+    // precondition: background+candidates keeps the initial path unique, background alone does not
+    log() << "\rInfo: removing walls... " << background.size() + candidates.size() << "                     " << std::flush;
+    if (m_aborted || (m_wallBound && m_certainWalls >= *m_wallBound))
+    {
+        m_aborted = true;
+        return {};
+    }
+    if (candidates.size() <= 1)
+    {
+        // a single remaining candidate always ends up in the result
+        m_certainWalls += candidates.size();
+        return candidates;
+    }
+
+    const std::vector<Wall> candidates1(candidates.begin(), candidates.begin() + candidates.size() / 2);
+    const std::vector<Wall> candidates2(candidates.begin() + candidates.size() / 2, candidates.end());
+    std::unordered_set<int> conflict;
+
+    auto inConflict = [this, &conflict](const std::vector<Wall>& walls)
+    {
+        std::vector<Wall> result;
+        for (auto wall: walls)
+        {
+            if (conflict.find(toInt(~w2lit(wall))) != conflict.end())
+            {
+                result.push_back(wall);
+            }
+        }
+        return result;
+    };
+
+    std::vector<Wall> background1 = background;
+    background1.insert(background1.end(), candidates1.begin(), candidates1.end());
+    if (isUnique(s, background1, conflict))
+    {
+        // the second half is not needed at all, the conflict tells which walls of the first half are
+        return quickXplain(s, background, inConflict(candidates1));
+    }
+
+    std::vector<Wall> essential2 = quickXplain(s, background1, candidates2);
+    if (m_aborted)
+    {
+        return {};
+    }
+
+    std::vector<Wall> background2 = background;
+    background2.insert(background2.end(), essential2.begin(), essential2.end());
+    if (isUnique(s, background2, conflict))
+    {
+        return essential2;
+    }
+
+    std::vector<Wall> essential1 = quickXplain(s, background2, candidates1);
+    essential1.insert(essential1.end(), essential2.begin(), essential2.end());
+    return essential1;
+}
+
+
+bool Generator::isUnique(SatSolver& s, const std::vector<Wall>& closedWalls, std::unordered_set<int>& conflict)
+{
+    if (hasSymmetricAlternative(closedWalls))
+    {
+        return false;
+    }
+
+    std::vector<Lit> assumptions;
+    for (auto wall: closedWalls)
+    {
+        assumptions.push_back(w2lit(wall));
+    }
+    if (solve(s, assumptions))
+    {
+        return false;
+    }
+
+    getConflictSet(lastConflict(s), conflict);
+    return true;
+}
+
+
+bool Generator::solve(SatSolver& s, const std::vector<Lit>& assumptions)
+{
+    ++m_stats.solveCalls;
+    std::vector<Lit> guarded;
+    if (!m_puzzleGuard.isUndefined())
+    {
+        guarded.push_back(m_puzzleGuard);
+        guarded.insert(guarded.end(), assumptions.begin(), assumptions.end());
+    }
+    const std::vector<Lit>& all = m_puzzleGuard.isUndefined() ? assumptions : guarded;
+    
+    m_cubed = !m_cubes.empty();
+    if (m_cubed)
+    {
+        return solveCubes(all);
+    }
+    m_modelSolver = &s;
+    return s.solve(all);
+}
+
+
+bool Generator::solveCubes(const std::vector<Lit>& assumptions)
+{
+    // the cube solvers get the same variables as the main solver (buildFormula is deterministic) and replay the
+    // clauses added by the generator; they never see the symmetry breaking, which is switched off at this point
+    const std::size_t threads = std::min<std::size_t>(m_cubeThreads, m_cubes.size());
+    while (m_cubeSolvers.size() < threads)
+    {
+        std::unique_ptr<SatSolver> solver = SatSolver::create();
+        std::map<std::pair<int, int>, Lit> fp2lit;
+        std::map<Wall, Lit> w2lit;
+        buildFormula(w(), h(), m_template.getHoles(), *solver, fp2lit, w2lit, m_encoding);
+        while (!m_puzzleGuard.isUndefined() && solver->nVars() <= m_puzzleGuard.var())
+        {
+            solver->newVar();
+        }
+        solver->setPhase("cube");
+        m_cubeSolvers.push_back(std::move(solver));
+        m_cubeSolverClauses.push_back(0);
+    }
+    
+    // the union of the cubes' conflicts (without the cube literals) is a conflict of the whole proof
+    std::unordered_set<int> assumed;
+    for (auto lit: assumptions)
+    {
+        assumed.insert(toInt(~lit));
+    }
+    std::unordered_set<int> merged;
+    m_cubeConflict.clear();
+    
+    std::mutex mutex;
+    std::atomic<std::size_t> nextCube(0);
+    std::atomic<bool> satisfiable(false);
+    auto worker = [&](std::size_t k)
+    {
+        SatSolver& solver = *m_cubeSolvers[k];
+        for (/**/; m_cubeSolverClauses[k] < m_clauseLog.size(); ++m_cubeSolverClauses[k])
+        {
+            solver.addClause(m_clauseLog[m_cubeSolverClauses[k]]);
+        }
+        
+        for (std::size_t cube = nextCube++; cube < m_cubes.size() && !satisfiable; cube = nextCube++)
+        {
+            std::vector<Lit> cubeAssumptions = assumptions;
+            cubeAssumptions.insert(cubeAssumptions.end(), m_cubes[cube].begin(), m_cubes[cube].end());
+            const bool result = solver.solve(cubeAssumptions);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            if (result)
+            {
+                if (!satisfiable)
+                {
+                    // the first alternative path wins, the other cubes are moot
+                    satisfiable = true;
+                    m_modelSolver = &solver;
+                    for (std::size_t other = 0; other < threads; ++other)
+                    {
+                        if (other != k)
+                        {
+                            m_cubeSolvers[other]->interrupt();
+                        }
+                    }
+                }
+                return;
+            }
+            if (solver.interrupted())
+            {
+                return;
+            }
+            for (auto lit: solver.conflict())
+            {
+                if (assumed.count(toInt(lit)) != 0 && merged.insert(toInt(lit)).second)
+                {
+                    m_cubeConflict.push_back(lit);
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (std::size_t k = 0; k < threads; ++k)
+    {
+        pool.emplace_back(worker, k);
+    }
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+    for (std::size_t k = 0; k < threads; ++k)
+    {
+        m_cubeSolvers[k]->clearInterrupt();
+    }
+    return satisfiable;
+}
+
+
+void Generator::addClause(SatSolver& s, std::vector<Lit> clause)
+{
+    if (!m_puzzleGuard.isUndefined())
+    {
+        clause.push_back(~m_puzzleGuard);
+    }
+    s.addClause(clause);
+    if (m_cubeThreads > 1)
+    {
+        m_clauseLog.push_back(clause);
+    }
+}
+
+void Generator::getConflictSet(const std::vector<Lit>& conflictVec, std::unordered_set<int>& conflictSet) const
 {
     conflictSet.clear();
-    for (int i = 0; i < conflictVec.size(); ++i) {
-        conflictSet.insert(Minisat::toInt(conflictVec[i]));
+    for (auto lit: conflictVec) {
+        conflictSet.insert(toInt(lit));
     }
 }
@@ -24,44 +24,129 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <iostream>
 #include <map>
+#include <memory>
 #include <random>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include <core/SolverTypes.h>
-
+#include "backbone.h"
 #include "board.h"
+#include "formula.h"
+#include "geometry.h"
+#include "learnedClauseCache.h"
+#include "pairCache.h"
 #include "templateBoard.h"
 
+struct GeneratorStats
+{
+    unsigned int solveCalls = 0;
+    unsigned int milliseconds = 0;
+};
+
 class Generator
 {
     public:
       Generator(const TemplateBoard& templateBoard, unsigned int seed);
 
+      // optional cache of infeasible entry/exit pairs, shared between generators
+      void setPairCache(PairCache* cache) { m_pairCache = cache; }
+
+      // short clauses learned over the base formula while searching the initial path, shared between generators
+      // and runs of the same template and encoding
+      void setLearnedClauseCache(LearnedClauseCache* cache) { m_learnedClauses = cache; }
+
+      void setEncoding(Encoding encoding) { m_encoding = encoding; }
+
+      // walls that every or no path of the template crosses, computed once per template and fixed open up front
+      void setBackboneCache(BackboneCache* cache) { m_backbones = cache; }
+
+      // progress output on std::cout, turned off for generators running in parallel
+      void setVerbose(bool verbose) { m_verbose = verbose; }
+
+      // split the uniqueness proofs after the initial path into cubes (one per entry field of the
+      // alternative path), solved on that many solvers in parallel; 0 or 1 = single solver
+      void setCubeThreads(unsigned int threads) { m_cubeThreads = threads; }
+
+      // give up (get() returns an empty board) as soon as the board cannot have fewer walls than *bound
+      void setWallBound(const std::atomic<int>* bound) { m_wallBound = bound; }
+      bool aborted() const { return m_aborted; }
+
       Board get();
 
+      unsigned int seed() const { return m_seed; }
+      const Path& solution() const { return m_solution; }
+      const GeneratorStats& stats() const { return m_stats; }
+
     private:
-      int w() const { return m_template.width(); }
-      int h() const { return m_template.height(); }
+      // one try with the hopeless paths excluded; sets hopeless (and returns an empty board) if the initial path turns out to be one
+      Board generate(bool& hopeless);
 
-      int c2f(const Coordinates& c) const { return c.x() + w() * c.y(); }
-      Coordinates f2c(int f) const { return {f%w(), f/w()}; }
+      std::ostream& log() { return m_verbose ? std::cout : m_null; }
 
-      Minisat::Lit fp2lit(int f, int p) const { auto it = m_fp2lit.find({f, p}); return (it != m_fp2lit.end()) ? it->second : Minisat::Lit(); }
-      Minisat::Lit w2lit(const Wall& wall) const { auto it = m_w2lit.find(wall); return (it != m_w2lit.end()) ? it->second : Minisat::Lit(); }
+      int w() const { return m_template.width(); }
+      int h() const { return m_template.height(); }
 
-      void getConflictSet(const Minisat::vec<Minisat::Lit>& conflictVec, std::unordered_set<int>& conflictSet) const;
+      int c2f(const Coordinates& c) const { return ::c2f(c, w()); }
+      Coordinates f2c(int f) const { return ::f2c(f, w()); }
+
+      Lit fp2lit(int f, int p) const { auto it = m_fp2lit.find({f, p}); return (it != m_fp2lit.end()) ? it->second : Lit(); }
+      Lit w2lit(const Wall& wall) const { return m_wallLits[wallIndex(wall, w(), h())]; }
+
+      // path of the model of the last satisfiable solve()
+      Path modelPath() const;
+      // a symmetric copy of the initial path survives the given closed walls
+      bool hasSymmetricAlternative(const std::vector<Wall>& closedWalls) const;
+      // minimal subset of candidates that keeps the initial path unique (given background is not enough)
+      std::vector<Wall> quickXplain(SatSolver& s, const std::vector<Wall>& background, const std::vector<Wall>& candidates);
+      bool isUnique(SatSolver& s, const std::vector<Wall>& closedWalls, std::unordered_set<int>& conflict);
+      bool solve(SatSolver& s, const std::vector<Lit>& assumptions);
+      // like SatSolver::conflict(), also for a solve() that was split into cubes
+      const std::vector<Lit>& lastConflict(const SatSolver& s) const { return m_cubed ? m_cubeConflict : s.conflict(); }
+      bool solveCubes(const std::vector<Lit>& assumptions);
+      // adds the clause (guarded by m_puzzleGuard, if any) to s and, if cubes are used, to the log that the cube solvers replay
+      void addClause(SatSolver& s, std::vector<Lit> clause);
+      void getConflictSet(const std::vector<Lit>& conflictVec, std::unordered_set<int>& conflictSet) const;
       template<typename T> const T& choice(const std::vector<T>& v);
       template<typename T> T takeChoice(std::vector<T>& v);
 
     private:
+      unsigned int m_seed;
       std::mt19937 m_rng;
       TemplateBoard m_template;
-      std::map<std::pair<int, int>, Minisat::Lit> m_fp2lit;
-      std::map<Wall, Minisat::Lit> m_w2lit;
+      std::vector<Transform> m_symmetries;
+      Path m_solution;
+      // initial paths that cannot be made unique by closing walls
+      std::vector<Path> m_hopelessPaths;
+      GeneratorStats m_stats;
+      PairCache* m_pairCache = nullptr;
+      LearnedClauseCache* m_learnedClauses = nullptr;
+      Encoding m_encoding = Encoding::Pairwise;
+      BackboneCache* m_backbones = nullptr;
+      // assumed in every solve call, so that the clauses of the puzzle can be told from learned ones
+      Lit m_puzzleGuard;
+      const std::atomic<int>* m_wallBound = nullptr;
+      // walls that are certainly closed in the final board (lower bound for m_wallBound)
+      int m_certainWalls = 0;
+      bool m_aborted = false;
+      bool m_verbose = true;
+      std::ostream m_null{nullptr};
+      std::map<std::pair<int, int>, Lit> m_fp2lit;
+      std::map<Wall, Lit> m_w2lit;
+      // m_w2lit by wall index (see wallIndex), undefined for walls without a variable
+      std::vector<Lit> m_wallLits;
+      const SatSolver* m_modelSolver = nullptr;
+      unsigned int m_cubeThreads = 0;
+      std::vector<std::vector<Lit>> m_cubes;
+      std::vector<std::vector<Lit>> m_clauseLog;
+      std::vector<std::unique_ptr<SatSolver>> m_cubeSolvers;
+      std::vector<std::size_t> m_cubeSolverClauses;
+      std::vector<Lit> m_cubeConflict;
+      bool m_cubed = false;
 };
 
 
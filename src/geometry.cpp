@@ -0,0 +1,98 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include "geometry.h"
+
+Geometry::Geometry(int width, int height, const std::vector<bool>& holes) :
+    m_width(width),
+    m_height(height),
+    m_pathLength(width * height),
+    m_holes(holes),
+    m_neighbours(width * height),
+    m_neighbourWalls(width * height),
+    m_nonNeighbours(width * height)
+{
+    if (std::find(m_holes.begin(), m_holes.end(), true) == m_holes.end())
+    {
+        m_holes.clear();
+    }
+    auto present = [this](int x, int y) { return !isHole(::c2f({x, y}, m_width)); };
+    
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (!present(x, y))
+            {
+                --m_pathLength;
+                continue;
+            }
+            std::vector<int>& n = m_neighbours[::c2f({x, y}, width)];
+            std::vector<int>& w = m_neighbourWalls[::c2f({x, y}, width)];
+            if (x > 0 && present(x - 1, y))          { n.push_back(::c2f({x - 1, y}, width)); w.push_back(verticalWallIndex(x, y, width)); }
+            if (x + 1 < width && present(x + 1, y))  { n.push_back(::c2f({x + 1, y}, width)); w.push_back(verticalWallIndex(x + 1, y, width)); }
+            if (y > 0 && present(x, y - 1))          { n.push_back(::c2f({x, y - 1}, width)); w.push_back(horizontalWallIndex(x, y, width, height)); }
+            if (y + 1 < height && present(x, y + 1)) { n.push_back(::c2f({x, y + 1}, width)); w.push_back(horizontalWallIndex(x, y + 1, width, height)); }
+        }
+    }
+    for (int f = 0; f < width * height; ++f)
+    {
+        if (isHole(f))
+        {
+            continue;
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                const int g = ::c2f({x, y}, width);
+                if (g != f && present(x, y) && !isNeighbour(f, g))
+                {
+                    m_nonNeighbours[f].push_back(g);
+                }
+            }
+        }
+    }
+    for (int x = 0; x < width; ++x)
+    {
+        if (present(x, 0))          m_edgeFields.push_back(::c2f({x, 0}, width));
+        if (present(x, height - 1)) m_edgeFields.push_back(::c2f({x, height - 1}, width));
+    }
+    for (int y = 1; y < height - 1; ++y)
+    {
+        if (present(0, y))          m_edgeFields.push_back(::c2f({0, y}, width));
+        if (present(width - 1, y))  m_edgeFields.push_back(::c2f({width - 1, y}, width));
+    }
+    for (int y = 1; y < height - 1; ++y)
+    {
+        for (int x = 1; x < width - 1; ++x)
+        {
+            if (present(x, y) && !borderWalls(*this, ::c2f({x, y}, width)).empty())
+            {
+                m_edgeFields.push_back(::c2f({x, y}, width));
+            }
+        }
+    }
+}
@@ -0,0 +1,279 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "coordinates.h"
+#include "wall.h"
+
+// Board geometry: row major field numbering, neighbour tables (left, right,
+// top, bottom) with the index of the wall between a field and its neighbour
+// (see wallIndex), non-neighbour lists (all other fields that are not
+// neighbours, in column major order like the formula's field loops), and edge
+// fields (top/bottom row, then left/right column,
+// then inner fields next to a hole).
+//
+// FixedGeometry<W, H> holds constexpr tables with 64 bit neighbour bitboards
+// for the common board sizes, Geometry is the runtime sized fallback with the
+// same interface. Code that is generic in the geometry is instantiated for all
+// fixed sizes via withGeometry().
+//
+// Only Geometry knows holes (fields cut out of the board): they keep their
+// field numbers, but are nobody's neighbour and not part of pathLength().
+
+inline int c2f(const Coordinates& c, int width)
+{
+    return c.x() + c.y() * width;
+}
+
+
+inline Coordinates f2c(int f, int width)
+{
+    return {f % width, f / width};
+}
+
+
+// walls are numbered row by row, vertical walls first (like Board::wallIndex)
+constexpr int wallCount(int width, int height)
+{
+    return (width + 1) * height + width * (height + 1);
+}
+
+
+constexpr int verticalWallIndex(int x, int y, int width)
+{
+    return y * (width + 1) + x;
+}
+
+
+constexpr int horizontalWallIndex(int x, int y, int width, int height)
+{
+    return (width + 1) * height + y * width + x;
+}
+
+
+inline int wallIndex(const Wall& w, int width, int height)
+{
+    const Coordinates& c = w.m_coordinates;
+    return (w.m_orientation == Orientation::V) ? verticalWallIndex(c.x(), c.y(), width) : horizontalWallIndex(c.x(), c.y(), width, height);
+}
+
+
+template<int W, int H>
+struct GeometryTables
+{
+    static_assert(W * H <= 64, "neighbour bitboards have 64 bits");
+
+    int neighbourCount[W * H];
+    int neighbours[W * H][4];
+    int neighbourWalls[W * H][4];
+    uint64_t neighbourMask[W * H];
+    int nonNeighbourCount[W * H];
+    uint8_t nonNeighbours[W * H][W * H];
+    int edgeFieldCount;
+    int edgeFields[2 * (W + H)];
+
+    constexpr GeometryTables() :
+        neighbourCount(),
+        neighbours(),
+        neighbourWalls(),
+        neighbourMask(),
+        nonNeighbourCount(),
+        nonNeighbours(),
+        edgeFieldCount(0),
+        edgeFields()
+    {
+        for (int y = 0; y < H; ++y)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                const int f = x + W * y;
+                const int candidates[4][3] = {{x > 0, x - 1, y}, {x + 1 < W, x + 1, y}, {y > 0, x, y - 1}, {y + 1 < H, x, y + 1}};
+                const int walls[4] = {verticalWallIndex(x, y, W), verticalWallIndex(x + 1, y, W),
+                    horizontalWallIndex(x, y, W, H), horizontalWallIndex(x, y + 1, W, H)};
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (candidates[i][0])
+                    {
+                        const int n = candidates[i][1] + W * candidates[i][2];
+                        neighbourWalls[f][neighbourCount[f]] = walls[i];
+                        neighbours[f][neighbourCount[f]++] = n;
+                        neighbourMask[f] |= uint64_t(1) << n;
+                    }
+                }
+            }
+        }
+        for (int f = 0; f < W * H; ++f)
+        {
+            for (int x = 0; x < W; ++x)
+            {
+                for (int y = 0; y < H; ++y)
+                {
+                    const int g = x + W * y;
+                    if (g != f && !((neighbourMask[f] >> g) & 1))
+                    {
+                        nonNeighbours[f][nonNeighbourCount[f]++] = g;
+                    }
+                }
+            }
+        }
+        for (int x = 0; x < W; ++x)
+        {
+            edgeFields[edgeFieldCount++] = x;
+            edgeFields[edgeFieldCount++] = x + W * (H - 1);
+        }
+        for (int y = 1; y < H - 1; ++y)
+        {
+            edgeFields[edgeFieldCount++] = W * y;
+            edgeFields[edgeFieldCount++] = W - 1 + W * y;
+        }
+    }
+};
+
+
+template<int W, int H>
+class FixedGeometry
+{
+    public:
+        static constexpr int width() { return W; }
+        static constexpr int height() { return H; }
+        static constexpr int fields() { return W * H; }
+        static constexpr int pathLength() { return W * H; }
+        static constexpr int walls() { return wallCount(W, H); }
+        static constexpr bool isHole(int) { return false; }
+
+        static int c2f(const Coordinates& c) { return c.x() + W * c.y(); }
+        static Coordinates f2c(int f) { return {f % W, f / W}; }
+
+        static constexpr int neighbourCount(int f) { return s_tables.neighbourCount[f]; }
+        static constexpr int neighbour(int f, int i) { return s_tables.neighbours[f][i]; }
+        static constexpr bool isNeighbour(int f, int g) { return (s_tables.neighbourMask[f] >> g) & 1; }
+        // index of the wall between f and neighbour(f, i)
+        static constexpr int neighbourWall(int f, int i) { return s_tables.neighbourWalls[f][i]; }
+        static constexpr int nonNeighbourCount(int f) { return s_tables.nonNeighbourCount[f]; }
+        static constexpr int nonNeighbour(int f, int i) { return s_tables.nonNeighbours[f][i]; }
+
+        static constexpr int edgeFieldCount() { return s_tables.edgeFieldCount; }
+        static constexpr int edgeField(int i) { return s_tables.edgeFields[i]; }
+
+    private:
+        static constexpr GeometryTables<W, H> s_tables = GeometryTables<W, H>();
+};
+
+template<int W, int H>
+constexpr GeometryTables<W, H> FixedGeometry<W, H>::s_tables;
+
+
+class Geometry
+{
+    public:
+        // holes: one flag per field, empty for a full rectangle
+        Geometry(int width, int height, const std::vector<bool>& holes = std::vector<bool>());
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        int fields() const { return m_width * m_height; }
+        int pathLength() const { return m_pathLength; }
+        int walls() const { return wallCount(m_width, m_height); }
+        bool isHole(int f) const { return !m_holes.empty() && m_holes[f]; }
+
+        int c2f(const Coordinates& c) const { return ::c2f(c, m_width); }
+        Coordinates f2c(int f) const { return ::f2c(f, m_width); }
+
+        int neighbourCount(int f) const { return m_neighbours[f].size(); }
+        int neighbour(int f, int i) const { return m_neighbours[f][i]; }
+        bool isNeighbour(int f, int g) const { return std::abs(f % m_width - g % m_width) + std::abs(f / m_width - g / m_width) == 1; }
+        int neighbourWall(int f, int i) const { return m_neighbourWalls[f][i]; }
+        // holes are nobody's non-neighbour either
+        int nonNeighbourCount(int f) const { return m_nonNeighbours[f].size(); }
+        int nonNeighbour(int f, int i) const { return m_nonNeighbours[f][i]; }
+
+        int edgeFieldCount() const { return m_edgeFields.size(); }
+        int edgeField(int i) const { return m_edgeFields[i]; }
+        const std::vector<int>& edgeFields() const { return m_edgeFields; }
+
+    private:
+        int m_width;
+        int m_height;
+        int m_pathLength;
+        std::vector<bool> m_holes;
+        std::vector<std::vector<int>> m_neighbours;
+        std::vector<std::vector<int>> m_neighbourWalls;
+        std::vector<std::vector<int>> m_nonNeighbours;
+        std::vector<int> m_edgeFields;
+};
+
+
+// the walls a path can enter or leave the field through (towards the outside
+// or a hole) in the order left, right, top, bottom; empty for inner fields
+template<typename G>
+std::vector<Wall> borderWalls(const G& g, int field)
+{
+    const Coordinates c = g.f2c(field);
+    auto outside = [&g](int x, int y) { return x < 0 || y < 0 || x >= g.width() || y >= g.height() || g.isHole(g.c2f({x, y})); };
+    std::vector<Wall> walls;
+    if (outside(c.x() - 1, c.y())) walls.push_back(Wall(c, Orientation::V));
+    if (outside(c.x() + 1, c.y())) walls.push_back(Wall(c.offset(1, 0), Orientation::V));
+    if (outside(c.x(), c.y() - 1)) walls.push_back(Wall(c, Orientation::H));
+    if (outside(c.x(), c.y() + 1)) walls.push_back(Wall(c.offset(0, 1), Orientation::H));
+    return walls;
+}
+
+
+// calls f with FixedGeometry<W, H> for 5 <= W, H <= 8 and with Geometry otherwise
+template<int W, int H>
+struct GeometryDispatch
+{
+    template<typename F>
+    static void run(int width, int height, F& f)
+    {
+        if (width == W && height == H)
+        {
+            f(FixedGeometry<W, H>());
+            return;
+        }
+        GeometryDispatch<(H == 8) ? W + 1 : W, (H == 8) ? 5 : H + 1>::run(width, height, f);
+    }
+};
+
+template<>
+struct GeometryDispatch<9, 5>
+{
+    template<typename F>
+    static void run(int width, int height, F& f)
+    {
+        f(Geometry(width, height));
+    }
+};
+
+template<typename F>
+void withGeometry(int width, int height, F f)
+{
+    GeometryDispatch<5, 5>::run(width, height, f);
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <cstdint>
+
+#include "ipasirSolver.h"
+
+extern "C"
+{
+    const char* ipasir_signature();
+    void* ipasir_init();
+    void ipasir_release(void* solver);
+    void ipasir_add(void* solver, int32_t litOrZero);
+    void ipasir_assume(void* solver, int32_t lit);
+    int ipasir_solve(void* solver);
+    int32_t ipasir_val(void* solver, int32_t lit);
+    int ipasir_failed(void* solver, int32_t lit);
+    void ipasir_set_terminate(void* solver, void* state, int (*terminate)(void* state));
+    void ipasir_set_learn(void* solver, void* state, int maxLength, void (*learn)(void* state, int32_t* clause));
+}
+
+namespace
+{
+    // IPASIR literals are non-zero DIMACS integers
+    int32_t toIpasir(Lit lit)
+    {
+        return lit.sign() ? -(lit.var() + 1) : (lit.var() + 1);
+    }
+    
+    Lit fromIpasir(int32_t lit)
+    {
+        return (lit < 0) ? mkLit(-lit - 1, true) : mkLit(lit - 1);
+    }
+    
+    // learned clauses kept between two takeLearnedClauses() calls
+    const std::size_t maxLearnedClauses = 50000;
+}
+
+
+IpasirSolver::IpasirSolver() :
+    m_solver(ipasir_init())
+{
+    ipasir_set_terminate(m_solver, this, &IpasirSolver::terminate);
+}
+
+
+IpasirSolver::~IpasirSolver()
+{
+    ipasir_release(m_solver);
+}
+
+
+std::string IpasirSolver::name() const
+{
+    return ipasir_signature();
+}
+
+
+int IpasirSolver::terminate(void* state)
+{
+    return static_cast<IpasirSolver*>(state)->m_interrupt ? 1 : 0;
+}
+
+
+void IpasirSolver::learn(void* state, int32_t* clause)
+{
+    IpasirSolver& solver = *static_cast<IpasirSolver*>(state);
+    if (solver.m_learned.size() >= maxLearnedClauses)
+    {
+        return;
+    }
+    std::vector<Lit> learned;
+    for (/**/; *clause != 0; ++clause)
+    {
+        const Lit lit = fromIpasir(*clause);
+        if (lit.var() >= solver.m_learnedVars)
+        {
+            return;
+        }
+        learned.push_back(lit);
+    }
+    solver.m_learned.push_back(learned);
+}
+
+
+void IpasirSolver::keepLearnedClauses(int maxLength, int /*maxLbd*/)
+{
+    m_learnedVars = m_vars;
+    ipasir_set_learn(m_solver, this, maxLength, (maxLength > 0) ? &IpasirSolver::learn : nullptr);
+}
+
+
+std::vector<std::vector<Lit>> IpasirSolver::takeLearnedClauses()
+{
+    std::vector<std::vector<Lit>> learned;
+    learned.swap(m_learned);
+    return learned;
+}
+
+
+void IpasirSolver::add(const std::vector<Lit>& clause)
+{
+    for (auto lit: clause)
+    {
+        ipasir_add(m_solver, toIpasir(lit));
+    }
+    ipasir_add(m_solver, 0);
+    ++m_clauses;
+}
+
+
+bool IpasirSolver::run(const std::vector<Lit>& assumptions)
+{
+    for (auto lit: assumptions)
+    {
+        ipasir_assume(m_solver, toIpasir(lit));
+    }
+    
+    const int result = ipasir_solve(m_solver);
+    m_interrupted = (result == 0);
+    m_model.clear();
+    m_conflict.clear();
+    if (result == 10)
+    {
+        m_model.resize(m_vars);
+        for (int var = 0; var < m_vars; ++var)
+        {
+            m_model[var] = ipasir_val(m_solver, var + 1) > 0;
+        }
+    }
+    else if (result == 20)
+    {
+        for (auto lit: assumptions)
+        {
+            if (ipasir_failed(m_solver, toIpasir(lit)))
+            {
+                m_conflict.push_back(~lit);
+            }
+        }
+    }
+    return result == 10;
+}
+
+
+bool IpasirSolver::modelValue(Lit lit) const
+{
+    const int var = lit.var();
+    if (var < 0 || var >= static_cast<int>(m_model.size()))
+    {
+        return false;
+    }
+    return m_model[var] != lit.sign();
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "satSolver.h"
+
+// Adapter for any solver implementing the IPASIR interface of the SAT
+// competition's incremental track (CaDiCaL, Kissat-style solvers, ...),
+// linked at build time with SAT_BACKEND=ipasir IPASIR_LIBRARY=...
+class IpasirSolver : public SatSolver
+{
+    public:
+        IpasirSolver();
+        ~IpasirSolver();
+        
+        IpasirSolver(const IpasirSolver&) = delete;
+        IpasirSolver& operator=(const IpasirSolver&) = delete;
+        
+        std::string name() const override;
+        
+        int newVar() override { return m_vars++; }
+        int nVars() const override { return m_vars; }
+        int nClauses() const override { return m_clauses; }
+        
+        bool interrupted() const override { return m_interrupted; }
+        // not part of IPASIR
+        uint64_t conflicts() const override { return 0; }
+        void interrupt() override { m_interrupt = true; }
+        void clearInterrupt() override { m_interrupt = false; }
+        
+        bool modelValue(Lit lit) const override;
+        const std::vector<Lit>& conflict() const override { return m_conflict; }
+        
+        // IPASIR reports learned clauses while solving, without their LBD:
+        // maxLbd is ignored, and only clauses over the variables existing at
+        // the time of the call are kept (up to a fixed number), so clauses
+        // with later guard variables do not pile up during long solves
+        void keepLearnedClauses(int maxLength, int maxLbd) override;
+        std::vector<std::vector<Lit>> takeLearnedClauses() override;
+    
+    protected:
+        void add(const std::vector<Lit>& clause) override;
+        bool run(const std::vector<Lit>& assumptions) override;
+    
+    private:
+        static int terminate(void* state);
+        static void learn(void* state, int32_t* clause);
+        
+        void* m_solver = nullptr;
+        int m_vars = 0;
+        int m_clauses = 0;
+        std::atomic<bool> m_interrupt{false};
+        bool m_interrupted = false;
+        // IPASIR only provides the model/failed assumptions until the next
+        // clause is added, so both are copied after each solve
+        std::vector<bool> m_model;
+        std::vector<Lit> m_conflict;
+        std::vector<std::vector<Lit>> m_learned;
+        int m_learnedVars = 0;
+};
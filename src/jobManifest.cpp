@@ -0,0 +1,169 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "jobManifest.h"
+#include "templateStream.h"
+
+namespace
+{
+    bool parseSetting(const std::string& setting, int& count, unsigned int& seed)
+    {
+        const auto pos = setting.find('=');
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+        const std::string key = setting.substr(0, pos);
+        std::istringstream value(setting.substr(pos + 1));
+        if (key == "count")
+        {
+            return (value >> count) && count >= 1;
+        }
+        if (key == "seed")
+        {
+            return static_cast<bool>(value >> seed);
+        }
+        return false;
+    }
+    
+    
+    std::string resolve(const std::string& manifest, const std::string& fileName)
+    {
+        const auto slash = manifest.find_last_of('/');
+        if (fileName.empty() || fileName[0] == '/' || slash == std::string::npos)
+        {
+            return fileName;
+        }
+        return manifest.substr(0, slash + 1) + fileName;
+    }
+}
+
+
+bool readJobManifest(const std::string& fileName, int defaultCount, unsigned int defaultSeed, std::vector<Job>& jobs)
+{
+    std::ifstream manifest(fileName);
+    if (!manifest)
+    {
+        std::cout << "Error: cannot open job manifest '" << fileName << "' for reading" << std::endl;
+        return false;
+    }
+    
+    std::string s;
+    int lineNumber = 0;
+    while (std::getline(manifest, s))
+    {
+        ++lineNumber;
+        const std::string source = fileName + ":" + std::to_string(lineNumber);
+        
+        std::istringstream line(s.substr(0, s.find('#')));
+        std::vector<std::string> tokens;
+        std::string token;
+        while (line >> token)
+        {
+            tokens.push_back(token);
+        }
+        if (tokens.empty())
+        {
+            continue;
+        }
+        
+        int width = 0;
+        int height = 0;
+        std::size_t settings = 1;
+        if (tokens.size() >= 2 && std::istringstream(tokens[0]) >> width && std::istringstream(tokens[1]) >> height)
+        {
+            settings = 2;
+        }
+        
+        int count = defaultCount;
+        unsigned int seed = defaultSeed;
+        for (std::size_t i = settings; i < tokens.size(); ++i)
+        {
+            if (!parseSetting(tokens[i], count, seed))
+            {
+                std::cout << "Error: bad setting '" << tokens[i] << "' in job manifest (" << source << ")" << std::endl;
+                return false;
+            }
+        }
+        
+        if (settings == 2)
+        {
+            if (width < 2 || height < 2)
+            {
+                std::cout << "Error: bad dimensions in job manifest (" << source << "), WIDTH and HEIGHT must be >= 2" << std::endl;
+                return false;
+            }
+            Job job;
+            job.board = TemplateBoard(width, height);
+            job.count = count;
+            job.seed = seed;
+            job.source = source;
+            jobs.push_back(job);
+            continue;
+        }
+        
+        const std::string templateFile = resolve(fileName, tokens[0]);
+        std::ifstream file(templateFile);
+        if (!file)
+        {
+            std::cout << "Error: cannot open template file '" << templateFile << "' for reading (" << source << ")" << std::endl;
+            return false;
+        }
+        TemplateStream templates(file);
+        TemplateEntry entry;
+        bool any = false;
+        while (templates.next(entry))
+        {
+            if (!entry.valid)
+            {
+                std::cout << "Error: syntax error in template file '" << templateFile << "' (template #" << entry.index << ", line " << entry.line << ")" << std::endl;
+                return false;
+            }
+            Job job;
+            job.board = entry.board;
+            job.count = (entry.count > 0) ? entry.count : count;
+            job.seed = entry.hasSeed ? entry.seed : seed;
+            job.source = source + ", template #" + std::to_string(entry.index);
+            jobs.push_back(job);
+            any = true;
+        }
+        if (!any)
+        {
+            std::cout << "Error: no template in template file '" << templateFile << "' (" << source << ")" << std::endl;
+            return false;
+        }
+    }
+    
+    if (jobs.empty())
+    {
+        std::cout << "Error: no job in job manifest '" << fileName << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
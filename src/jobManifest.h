@@ -0,0 +1,46 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "templateBoard.h"
+
+struct Job
+{
+    TemplateBoard board;
+    int count = 1;
+    unsigned int seed = 0;
+    std::string source;    // "manifest:line" or "manifest:line, template #n"
+};
+
+// Reads a job manifest: one job per line, either "WIDTH HEIGHT" or the name of
+// a template file (relative to the manifest), followed by optional settings
+// "count=N" and "seed=S"; '#' starts a comment. Every template of a template
+// file becomes a job of its own; settings of the template ("% count=...")
+// take precedence over those of the manifest line, which take precedence over
+// the given defaults. Reports errors on std::cout.
+bool readJobManifest(const std::string& fileName, int defaultCount, unsigned int defaultSeed, std::vector<Job>& jobs);
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include "learnedClauseCache.h"
+
+namespace
+{
+    // clauses per formula, keeps the file from growing without bounds
+    const std::size_t maxClauses = 50000;
+}
+
+
+bool LearnedClauseCache::open(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    {
+        std::ifstream file(fileName);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream is(line);
+            uint64_t hash = 0;
+            std::string encoding;
+            int variables = 0;
+            int clauses = 0;
+            if (!(is >> std::hex >> hash >> std::dec >> encoding >> variables >> clauses))
+            {
+                continue;
+            }
+            std::vector<Lit> clause;
+            int lit = 0;
+            while (is >> lit && lit != 0 && std::abs(lit) <= variables)
+            {
+                clause.push_back(mkLit(std::abs(lit) - 1, lit < 0));
+            }
+            if (lit == 0 && !clause.empty())
+            {
+                std::sort(clause.begin(), clause.end());
+                insert(Key(hash, encoding, variables, clauses), clause);
+            }
+        }
+    }
+    
+    m_file.open(fileName, std::ios::app);
+    return static_cast<bool>(m_file);
+}
+
+
+std::vector<std::vector<Lit>> LearnedClauseCache::get(const Key& key) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_clauses.find(key);
+    if (it == m_clauses.end())
+    {
+        return {};
+    }
+    return std::vector<std::vector<Lit>>(it->second.begin(), it->second.end());
+}
+
+
+std::size_t LearnedClauseCache::add(const Key& key, const std::vector<std::vector<Lit>>& clauses)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t added = 0;
+    for (auto clause: clauses)
+    {
+        std::sort(clause.begin(), clause.end());
+        if (!insert(key, clause))
+        {
+            continue;
+        }
+        ++added;
+        
+        if (m_file.is_open())
+        {
+            m_file << std::hex << std::setw(16) << std::setfill('0') << std::get<0>(key) << std::dec
+                << " " << std::get<1>(key) << " " << std::get<2>(key) << " " << std::get<3>(key);
+            for (auto lit: clause)
+            {
+                m_file << " " << (lit.sign() ? -(lit.var() + 1) : (lit.var() + 1));
+            }
+            m_file << " 0\n";
+        }
+    }
+    if (m_file.is_open())
+    {
+        m_file.flush();
+    }
+    return added;
+}
+
+
+std::size_t LearnedClauseCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t count = 0;
+    for (const auto& formula: m_clauses)
+    {
+        count += formula.second.size();
+    }
+    return count;
+}
+
+
+bool LearnedClauseCache::insert(const Key& key, const std::vector<Lit>& clause)
+{
+    std::set<std::vector<Lit>>& clauses = m_clauses[key];
+    if (clauses.size() >= maxClauses)
+    {
+        return false;
+    }
+    return clauses.insert(clause).second;
+}
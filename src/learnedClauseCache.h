@@ -0,0 +1,64 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "satSolver.h"
+
+// Short learned clauses of a base formula (buildFormula plus the fixed walls
+// of a template), per template hash (see TemplateBoard::hash), encoding and
+// formula size, so that a changed formula does not pick up stale clauses.
+// Optionally backed by a text file with one "hash encoding variables clauses
+// literals... 0" line per clause (DIMACS literals), which is loaded on open
+// and extended by every new clause. All methods are thread safe.
+class LearnedClauseCache
+{
+    public:
+        typedef std::tuple<uint64_t, std::string, int, int> Key;
+        
+        bool open(const std::string& fileName);
+        
+        std::vector<std::vector<Lit>> get(const Key& key) const;
+        // returns the number of new clauses
+        std::size_t add(const Key& key, const std::vector<std::vector<Lit>>& clauses);
+        
+        std::size_t size() const;
+    
+    private:
+        // clause sorted by literal
+        bool insert(const Key& key, const std::vector<Lit>& clause);
+        
+        mutable std::mutex m_mutex;
+        std::map<Key, std::set<std::vector<Lit>>> m_clauses;
+        std::ofstream m_file;
+};
@@ -22,72 +22,466 @@
 * SOFTWARE.
 *******************************************************************************/
 
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include "backbone.h"
+#include "bestOfGenerator.h"
 #include "board.h"
 #include "commandline.h"
+#include "costModel.h"
+#include "deduction.h"
+#include "duplicateFilter.h"
+#include "editSession.h"
 #include "generator.h"
+#include "jobManifest.h"
+#include "learnedClauseCache.h"
+#include "pairCache.h"
+#include "puzzleDatabase.h"
+#include "regionGenerator.h"
+#include "scheduler.h"
 #include "templateBoard.h"
+#include "templateStream.h"
+#include "trace.h"
+#include "verifier.h"
 
 
-int main(int argc, char** argv)
+enum class Verdict { Accepted, TooEasy, Duplicate };
+
+
+// rates the puzzle if requested, false if it is below --min-difficulty
+bool ratePuzzle(const Board& b, const Options& options, std::ostream& out)
 {
-    Options options;
-    if (!parseCommandLine(argc, argv, options))
+    if (options.rate || options.minDifficulty > 0)
     {
-        return 1;
+        const DeductionResult rating = Deduction(b).run();
+        out << "Info: difficulty=" << rating.difficulty()
+            << " (rules: degree=" << rating.steps[0] << " loop=" << rating.steps[1] << " parity=" << rating.steps[2] << " trial=" << rating.steps[3]
+            << ", deduced " << rating.decidedEdges << " of " << rating.openEdges << " edges)" << std::endl;
+        if (rating.difficulty() < options.minDifficulty)
+        {
+            out << "Info: dropping too easy puzzle" << std::endl;
+            return false;
+        }
     }
-    
-    TemplateBoard templateBoard;
-    if (!options.templateFile.empty())
+    return true;
+}
+
+
+// false if --dedup has seen the puzzle (or a rotated/mirrored copy) before
+bool isNewPuzzle(const Board& b, const Options& options, DuplicateFilter& duplicates)
+{
+    if (options.dedup && !duplicates.insert(b))
     {
-        std::ifstream file(options.templateFile);
-        if (!file)
+        std::cout << "Info: dropping duplicate puzzle" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+// rates the puzzle if requested and checks it against --min-difficulty and --dedup
+Verdict checkPuzzle(const Board& b, const Options& options, DuplicateFilter& duplicates)
+{
+    if (!ratePuzzle(b, options, std::cout))
+    {
+        return Verdict::TooEasy;
+    }
+    if (!isNewPuzzle(b, options, duplicates))
+    {
+        return Verdict::Duplicate;
+    }
+    return Verdict::Accepted;
+}
+
+
+// the --solve output: solvability, uniqueness, number of solutions and the solution
+std::string solvePuzzle(const Board& b)
+{
+    std::ostringstream out;
+    out << "Computing solution..." << std::endl;
+    std::tuple<bool, bool, Path> solution = b.solve();
+    if (std::get<0>(solution))
+    {
+        out << "Board is solvable" << std::endl;
+        
+        if (std::get<1>(solution))
         {
-            std::cout << "Error: cannot open template file '" << options.templateFile << "' for reading" << std::endl;
-            return 1;
+            out << "Board is uniquely solvable" << std::endl;
         }
-        if (!templateBoard.parse(file))
+        else
         {
-            std::cout << "Error: syntax error in template file '" << options.templateFile << "'" << std::endl;
-            return 1;
+            out << "Board is NOT uniquely solvable" << std::endl;
         }
+        
+        PathCount solutions = 0;
+        if (b.countSolutions(solutions))
+        {
+            out << "Number of solutions: " << toString(solutions) << std::endl;
+        }
+        
+        out << "Solution:" << std::endl;
+        b.print(out, std::get<2>(solution));
     }
     else
     {
-        templateBoard = TemplateBoard(options.width, options.height);
+        out << "Board is NOT solvable" << std::endl;
     }
+    return out.str();
+}
 
-    std::cout << templateBoard << std::endl;
 
-    const Board b = Generator(templateBoard, options.seed).get();
+// prints an accepted puzzle followed by its --solve output (if any) and adds it to the database
+bool outputPuzzle(const Board& b, const Path& solution, unsigned int puzzleSeed, uint64_t templateHash, const GeneratorStats& stats, const std::string& solveOutput, const Options& options, PuzzleDatabaseWriter& db)
+{
     std::cout << b << std::endl;
     
-    if (options.solve)
+    if (!options.databaseFile.empty())
     {
-        std::cout << "Computing solution..." << std::endl;
-        std::tuple<bool, bool, Path> solution = b.solve();
-        if (std::get<0>(solution))
+        PuzzleRecord record;
+        record.board = b;
+        record.solution = solution;
+        record.seed = puzzleSeed;
+        record.templateHash = templateHash;
+        record.solveCalls = stats.solveCalls;
+        record.milliseconds = stats.milliseconds;
+        if (!db.add(record))
         {
-            std::cout << "Board is solvable" << std::endl;
-            
-            if (std::get<1>(solution))
+            std::cout << "Error: cannot write puzzle database '" << options.databaseFile << "'" << std::endl;
+            return false;
+        }
+    }
+    
+    std::cout << solveOutput;
+    return true;
+}
+
+
+bool generatePuzzles(const TemplateBoard& templateBoard, unsigned int seed, int count, const Options& options, PuzzleDatabaseWriter& db, DuplicateFilter& duplicates, PairCache& pairCache, LearnedClauseCache& learnedClauses, BackboneCache& backbones)
+{
+    // every puzzle of a batch gets its own seed, so it can be reproduced individually
+    int generated = 0;
+    int duplicatesInRow = 0;
+    int easyInRow = 0;
+    for (unsigned int i = 0; generated < count; ++i)
+    {
+        Board b;
+        Path solution;
+        unsigned int puzzleSeed = 0;
+        GeneratorStats stats;
+        if (options.regionSize > 0)
+        {
+            RegionGenerator generator(templateBoard.width(), templateBoard.height(), seed == 0 ? 0 : seed + i, options.regionSize, options.threads);
+            generator.setLearnedClauseCache(options.learnedClausesFile.empty() ? nullptr : &learnedClauses);
+            generator.setEncoding(options.encoding);
+            generator.setBackboneCache(options.backboneFile.empty() ? nullptr : &backbones);
+            b = generator.get();
+            solution = generator.solution();
+            puzzleSeed = generator.seed();
+            stats = generator.stats();
+        }
+        else if (options.bestOf > 1)
+        {
+            BestOfGenerator generator(templateBoard, seed == 0 ? 0 : seed + i, options.bestOf, options.threads);
+            generator.setPairCache(&pairCache);
+            generator.setLearnedClauseCache(options.learnedClausesFile.empty() ? nullptr : &learnedClauses);
+            generator.setEncoding(options.encoding);
+            generator.setBackboneCache(options.backboneFile.empty() ? nullptr : &backbones);
+            b = generator.get();
+            solution = generator.solution();
+            puzzleSeed = generator.seed();
+            stats = generator.stats();
+        }
+        else
+        {
+            Generator generator(templateBoard, seed == 0 ? 0 : seed + i);
+            generator.setPairCache(&pairCache);
+            generator.setLearnedClauseCache(options.learnedClausesFile.empty() ? nullptr : &learnedClauses);
+            generator.setBackboneCache(options.backboneFile.empty() ? nullptr : &backbones);
+            generator.setEncoding(options.encoding);
+            generator.setCubeThreads(options.cubeThreads);
+            b = generator.get();
+            solution = generator.solution();
+            puzzleSeed = generator.seed();
+            stats = generator.stats();
+        }
+        if (b.width() == 0)
+        {
+            return false;
+        }
+        
+        const Verdict verdict = checkPuzzle(b, options, duplicates);
+        if (verdict == Verdict::TooEasy)
+        {
+            if (++easyInRow >= 100)
             {
-                std::cout << "Board is uniquely solvable" << std::endl;
+                std::cout << "Error: 100 too easy puzzles in a row, giving up" << std::endl;
+                return false;
             }
-            else
+            continue;
+        }
+        easyInRow = 0;
+        if (verdict == Verdict::Duplicate)
+        {
+            if (++duplicatesInRow >= 100)
             {
-                std::cout << "Board is NOT uniquely solvable" << std::endl;
+                std::cout << "Error: 100 duplicate puzzles in a row, giving up" << std::endl;
+                return false;
             }
-            
-            std::cout << "Solution:" << std::endl;
-            b.print(std::cout, std::get<2>(solution));
+            continue;
         }
-        else
+        duplicatesInRow = 0;
+        ++generated;
+        
+        if (!outputPuzzle(b, solution, puzzleSeed, templateBoard.hash(), stats, options.solve ? solvePuzzle(b) : std::string(), options, db))
         {
-            std::cout << "Board is NOT solvable" << std::endl;
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+bool runJobs(const Options& options, PuzzleDatabaseWriter& db, DuplicateFilter& duplicates, PairCache& pairCache, LearnedClauseCache& learnedClauses, BackboneCache& backbones)
+{
+    std::vector<Job> jobs;
+    if (!readJobManifest(options.jobsFile, options.count, options.seed, jobs))
+    {
+        return false;
+    }
+    
+    CostModel model;
+    if (!options.costModelFile.empty() && !model.open(options.costModelFile))
+    {
+        std::cout << "Error: cannot open cost model '" << options.costModelFile << "'" << std::endl;
+        return false;
+    }
+    model.fit();
+    
+    // one task per puzzle, so the puzzles of a large job spread over all workers
+    struct Task
+    {
+        std::size_t job;
+        int index;
+    };
+    std::vector<Task> tasks;
+    std::vector<double> costs;
+    for (std::size_t j = 0; j < jobs.size(); ++j)
+    {
+        const double cost = model.expectedMilliseconds(jobs[j].board);
+        for (int i = 0; i < jobs[j].count; ++i)
+        {
+            tasks.push_back({j, i});
+            costs.push_back(cost);
+        }
+    }
+    std::cout << "Info: scheduling " << tasks.size() << " puzzles of " << jobs.size() << " jobs (cost model from " << model.size() << " timings)" << std::endl;
+    
+    std::mutex outputMutex;
+    std::atomic<bool> success(true);
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t steals = runScheduled(costs, options.threads, [&](std::size_t t)
+    {
+        const Task& task = tasks[t];
+        const Job& job = jobs[task.job];
+        for (int attempt = 0; attempt < 100; ++attempt)
+        {
+            // same seeds as a batch of job.count puzzles; replacements for dropped puzzles come after the batch
+            Generator generator(job.board, job.seed == 0 ? 0 : job.seed + task.index + attempt * job.count);
+            generator.setVerbose(false);
+            generator.setPairCache(&pairCache);
+            generator.setLearnedClauseCache(options.learnedClausesFile.empty() ? nullptr : &learnedClauses);
+            generator.setBackboneCache(options.backboneFile.empty() ? nullptr : &backbones);
+            generator.setEncoding(options.encoding);
+            const Board b = generator.get();
+            
+            // rating and solving are the expensive parts of the output, so they run before taking the lock
+            std::ostringstream rating;
+            const bool hardEnough = b.width() != 0 && ratePuzzle(b, options, rating);
+            const std::string solveOutput = (hardEnough && options.solve) ? solvePuzzle(b) : std::string();
+            
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (b.width() == 0)
+            {
+                std::cout << "Error: cannot generate puzzle " << task.index + 1 << " of job " << job.source << std::endl;
+                success = false;
+                return;
+            }
+            model.record(job.board, generator.stats().milliseconds);
+            
+            std::cout << "Info: job " << job.source << ", puzzle " << task.index + 1 << " of " << job.count
+                << " (seed=" << generator.seed() << ", " << generator.stats().milliseconds << " ms)" << std::endl;
+            std::cout << rating.str();
+            if (!hardEnough || !isNewPuzzle(b, options, duplicates))
+            {
+                continue;
+            }
+            if (!outputPuzzle(b, generator.solution(), generator.seed(), job.board.hash(), generator.stats(), solveOutput, options, db))
+            {
+                success = false;
+            }
+            return;
         }
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << "Error: 100 dropped puzzles in a row for puzzle " << task.index + 1 << " of job " << job.source << ", giving up" << std::endl;
+        success = false;
+    });
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Info: finished " << tasks.size() << " puzzles in " << milliseconds << " ms (" << steals << " tasks stolen)" << std::endl;
+    
+    return success;
+}
+
+
+bool writeTrace(const Options& options)
+{
+    if (options.traceFile.empty())
+    {
+        return true;
+    }
+    if (!Trace::instance().write(options.traceFile))
+    {
+        std::cout << "Error: cannot write trace file '" << options.traceFile << "'" << std::endl;
+        return false;
+    }
+    std::cout << "Info: wrote solver trace to '" << options.traceFile << "'" << std::endl;
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseCommandLine(argc, argv, options))
+    {
+        return 1;
+    }
+    
+    if (!options.convertFiles.empty())
+    {
+        return convertPuzzles(options.convertFiles[0], options.convertFiles[1]) ? 0 : 1;
+    }
+    
+    if (!options.traceFile.empty())
+    {
+        Trace::instance().enable();
+    }
+    
+    if (!options.verifyFiles.empty())
+    {
+        const bool verified = verifyPuzzles(options.verifyFiles, options.threads);
+        return (writeTrace(options) && verified) ? 0 : 1;
+    }
+    
+    if (!options.editFile.empty())
+    {
+        const bool edited = runEditSession(options.editFile);
+        return (writeTrace(options) && edited) ? 0 : 1;
+    }
+    
+    PuzzleDatabaseWriter db;
+    if (!options.databaseFile.empty() && !db.open(options.databaseFile))
+    {
+        std::cout << "Error: cannot open puzzle database '" << options.databaseFile << "' for writing" << std::endl;
+        return 1;
+    }
+    
+    DuplicateFilter duplicates;
+    if (!options.dedupFile.empty() && !duplicates.open(options.dedupFile))
+    {
+        std::cout << "Error: cannot open hash file '" << options.dedupFile << "'" << std::endl;
+        return 1;
+    }
+    
+    // infeasible entry/exit pairs are shared by all puzzles of the run, and across runs with --pair-cache
+    PairCache pairCache;
+    if (!options.pairCacheFile.empty() && !pairCache.open(options.pairCacheFile))
+    {
+        std::cout << "Error: cannot open pair cache '" << options.pairCacheFile << "'" << std::endl;
+        return 1;
+    }
+    
+    LearnedClauseCache learnedClauses;
+    if (!options.learnedClausesFile.empty() && !learnedClauses.open(options.learnedClausesFile))
+    {
+        std::cout << "Error: cannot open learned clause cache '" << options.learnedClausesFile << "'" << std::endl;
+        return 1;
+    }
+    
+    BackboneCache backbones;
+    if (!options.backboneFile.empty() && !backbones.open(options.backboneFile))
+    {
+        std::cout << "Error: cannot open backbone cache '" << options.backboneFile << "'" << std::endl;
+        return 1;
+    }
+    
+    bool success = true;
+    if (!options.jobsFile.empty())
+    {
+        success = runJobs(options, db, duplicates, pairCache, learnedClauses, backbones);
     }
+    else if (!options.templateFile.empty())
+    {
+        // "-" reads the templates from stdin
+        std::ifstream file;
+        if (options.templateFile != "-")
+        {
+            file.open(options.templateFile);
+            if (!file)
+            {
+                std::cout << "Error: cannot open template file '" << options.templateFile << "' for reading" << std::endl;
+                return 1;
+            }
+        }
+        TemplateStream templates(options.templateFile == "-" ? std::cin : file);
         
-    return 0;
+        TemplateEntry current;
+        bool hasCurrent = templates.next(current);
+        if (!hasCurrent)
+        {
+            std::cout << "Error: no template in template file '" << options.templateFile << "'" << std::endl;
+            return 1;
+        }
+        while (hasCurrent)
+        {
+            // parse the next template while generating from the current one
+            TemplateEntry upcoming;
+            std::future<bool> parsed = std::async(std::launch::async, [&templates, &upcoming]() { return templates.next(upcoming); });
+            
+            if (!current.valid)
+            {
+                std::cout << "Error: syntax error in template file '" << options.templateFile << "' (template #" << current.index << ", line " << current.line << ")" << std::endl;
+                success = false;
+            }
+            else
+            {
+                std::cout << current.board << std::endl;
+                const unsigned int seed = current.hasSeed ? current.seed : options.seed;
+                const int count = (current.count > 0) ? current.count : options.count;
+                success = generatePuzzles(current.board, seed, count, options, db, duplicates, pairCache, learnedClauses, backbones) && success;
+            }
+            
+            hasCurrent = parsed.get();
+            current = upcoming;
+        }
+    }
+    else
+    {
+        const TemplateBoard templateBoard(options.width, options.height);
+        std::cout << templateBoard << std::endl;
+        success = generatePuzzles(templateBoard, options.seed, options.count, options, db, duplicates, pairCache, learnedClauses, backbones);
+    }
+    
+    if (!db.close())
+    {
+        std::cout << "Error: cannot write puzzle database '" << options.databaseFile << "'" << std::endl;
+        return 1;
+    }
+    
+    return (writeTrace(options) && success) ? 0 : 1;
 }
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <core/Solver.h>
+#include <simp/SimpSolver.h>
+
+#include "mergesatSolver.h"
+
+namespace
+{
+    Minisat::Lit toMinisat(Lit lit)
+    {
+        return Minisat::mkLit(lit.var(), lit.sign());
+    }
+    
+    Lit fromMinisat(Minisat::Lit lit)
+    {
+        return mkLit(Minisat::var(lit), Minisat::sign(lit));
+    }
+    
+    // the clause database is protected in Minisat-style solvers
+    class LearnedClauseAccess : public Minisat::SimpSolver
+    {
+        public:
+            void learnedClauses(int maxLength, int maxLbd, std::vector<std::vector<Lit>>& learned) const
+            {
+                const int units = (trail_lim.size() > 0) ? trail_lim[0] : trail.size();
+                for (int i = 0; i < units; ++i)
+                {
+                    learned.push_back({fromMinisat(trail[i])});
+                }
+                for (auto tier: {&learnts_core, &learnts_tier2, &learnts_local})
+                {
+                    for (int i = 0; i < tier->size(); ++i)
+                    {
+                        const auto& clause = ca[(*tier)[i]];
+                        if (clause.mark() == 1 || clause.size() > maxLength || static_cast<int>(clause.lbd()) > maxLbd)
+                        {
+                            continue;
+                        }
+                        std::vector<Lit> lits;
+                        for (int j = 0; j < clause.size(); ++j)
+                        {
+                            lits.push_back(fromMinisat(clause[j]));
+                        }
+                        learned.push_back(lits);
+                    }
+                }
+            }
+    };
+}
+
+
+MergesatSolver::MergesatSolver() :
+    m_solver(new LearnedClauseAccess)
+{}
+
+
+MergesatSolver::~MergesatSolver() = default;
+
+
+int MergesatSolver::newVar()
+{
+    return m_solver->newVar();
+}
+
+
+int MergesatSolver::nVars() const
+{
+    return m_solver->nVars();
+}
+
+
+int MergesatSolver::nClauses() const
+{
+    return m_solver->nClauses();
+}
+
+
+void MergesatSolver::add(const std::vector<Lit>& clause)
+{
+    Minisat::vec<Minisat::Lit> c;
+    for (auto lit: clause)
+    {
+        c.push(toMinisat(lit));
+    }
+    m_solver->addClause(c);
+}
+
+
+bool MergesatSolver::run(const std::vector<Lit>& assumptions)
+{
+    Minisat::vec<Minisat::Lit> a;
+    for (auto lit: assumptions)
+    {
+        a.push(toMinisat(lit));
+    }
+    
+    const Minisat::lbool result = m_solver->solveLimited(a);
+    m_interrupted = (Minisat::toInt(result) == 2 /* = Minisat::l_Undef */);
+    m_conflict.clear();
+    if (Minisat::toInt(result) == 1 /* = Minisat::l_False */)
+    {
+        for (int i = 0; i < m_solver->conflict.size(); ++i)
+        {
+            m_conflict.push_back(fromMinisat(m_solver->conflict[i]));
+        }
+    }
+    return Minisat::toInt(result) == 0 /* = Minisat::l_True */;
+}
+
+
+std::vector<std::vector<Lit>> MergesatSolver::takeLearnedClauses()
+{
+    std::vector<std::vector<Lit>> learned;
+    if (m_maxLearnedLength > 0)
+    {
+        static_cast<const LearnedClauseAccess&>(*m_solver).learnedClauses(m_maxLearnedLength, m_maxLearnedLbd, learned);
+    }
+    return learned;
+}
+
+
+uint64_t MergesatSolver::conflicts() const
+{
+    return m_solver->conflicts;
+}
+
+
+void MergesatSolver::interrupt()
+{
+    m_solver->interrupt();
+}
+
+
+void MergesatSolver::clearInterrupt()
+{
+    m_solver->clearInterrupt();
+}
+
+
+bool MergesatSolver::modelValue(Lit lit) const
+{
+    return Minisat::toInt(m_solver->modelValue(toMinisat(lit))) == 0 /* = Minisat::l_True */;
+}
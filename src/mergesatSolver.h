@@ -0,0 +1,68 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <memory>
+#include "satSolver.h"
+
+namespace Minisat { class SimpSolver; }
+
+class MergesatSolver : public SatSolver
+{
+    public:
+        MergesatSolver();
+        ~MergesatSolver();
+        
+        std::string name() const override { return "mergesat"; }
+        
+        int newVar() override;
+        int nVars() const override;
+        int nClauses() const override;
+        
+        bool interrupted() const override { return m_interrupted; }
+        uint64_t conflicts() const override;
+        void interrupt() override;
+        void clearInterrupt() override;
+        
+        bool modelValue(Lit lit) const override;
+        const std::vector<Lit>& conflict() const override { return m_conflict; }
+        
+        // the clauses of the learned clause database (and the units on decision level 0) at the time of the call
+        void keepLearnedClauses(int maxLength, int maxLbd) override { m_maxLearnedLength = maxLength; m_maxLearnedLbd = maxLbd; }
+        std::vector<std::vector<Lit>> takeLearnedClauses() override;
+    
+    protected:
+        void add(const std::vector<Lit>& clause) override;
+        bool run(const std::vector<Lit>& assumptions) override;
+        
+        std::unique_ptr<Minisat::SimpSolver> m_solver;
+    
+    private:
+        bool m_interrupted = false;
+        std::vector<Lit> m_conflict;
+        int m_maxLearnedLength = 0;
+        int m_maxLearnedLbd = 0;
+};
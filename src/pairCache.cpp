@@ -0,0 +1,78 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <iomanip>
+
+#include "pairCache.h"
+
+bool PairCache::open(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    {
+        std::ifstream file(fileName);
+        uint64_t hash = 0;
+        int entry = 0;
+        int exit = 0;
+        while (file >> std::hex >> hash >> std::dec >> entry >> exit)
+        {
+            m_infeasible.insert(Key(hash, entry, exit));
+        }
+    }
+    
+    m_file.open(fileName, std::ios::app);
+    return static_cast<bool>(m_file);
+}
+
+
+bool PairCache::isInfeasible(uint64_t templateHash, int entry, int exit) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_infeasible.count(Key(templateHash, entry, exit)) > 0
+        || m_infeasible.count(Key(templateHash, entry, -1)) > 0
+        || m_infeasible.count(Key(templateHash, -1, exit)) > 0
+        || m_infeasible.count(Key(templateHash, -1, -1)) > 0;
+}
+
+
+void PairCache::addInfeasible(uint64_t templateHash, int entry, int exit)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_infeasible.insert(Key(templateHash, entry, exit)).second)
+    {
+        return;
+    }
+    
+    if (m_file.is_open())
+    {
+        m_file << std::hex << std::setw(16) << std::setfill('0') << templateHash << std::dec << " " << entry << " " << exit << std::endl;
+    }
+}
+
+
+std::size_t PairCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_infeasible.size();
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+
+// Entry/exit field pairs that are known to admit no path, per template hash
+// (see TemplateBoard::hash). An entry or exit of -1 matches every field, e.g.
+// (hash, 5, -1) says that field 5 cannot be the entry field at all.
+// Optionally backed by a text file with one "hash entry exit" line per pair,
+// which is loaded on open and extended by every newly learned pair.
+// All methods are thread safe.
+class PairCache
+{
+    public:
+        bool open(const std::string& fileName);
+        
+        bool isInfeasible(uint64_t templateHash, int entry, int exit) const;
+        void addInfeasible(uint64_t templateHash, int entry, int exit);
+        
+        std::size_t size() const;
+    
+    private:
+        typedef std::tuple<uint64_t, int, int> Key;
+        
+        mutable std::mutex m_mutex;
+        std::set<Key> m_infeasible;
+        std::ofstream m_file;
+};
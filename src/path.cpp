@@ -22,67 +22,55 @@
 * SOFTWARE.
 *******************************************************************************/
 
+#include <algorithm>
 #include "path.h"
 
-bool Path::isBlockedBy(const Wall& wall) const
+
+Path Path::transformed(Transform t, int width, int height) const
 {
-    if (isEmpty()) return false;
-    
-    int maxX = -1;
-    int maxY = -1;
+    Path path;
     for (auto c: m_coordinates)
     {
-        maxX = std::max(maxX, c.x());
-        maxY = std::max(maxY, c.y());
+        path.m_coordinates.push_back(transform(c, t, width, height));
     }
+    return path;
+}
+
+
+Path Path::reversed() const
+{
+    Path path = *this;
+    std::reverse(path.m_coordinates.begin(), path.m_coordinates.end());
+    return path;
+}
+
+
+bool Path::isEquivalent(const Path& other) const
+{
+    if (m_coordinates.size() != other.m_coordinates.size())
+    {
+        return false;
+    }
+    return std::equal(m_coordinates.begin(), m_coordinates.end(), other.m_coordinates.begin()) ||
+        std::equal(m_coordinates.begin(), m_coordinates.end(), other.m_coordinates.rbegin());
+}
+
+
+bool Path::isBlockedBy(const Wall& wall) const
+{
+    if (isEmpty()) return false;
     
-    switch (wall.m_orientation)
+    // entry and exit cross a wall between an end field and the outside, i.e. a field
+    // that is not on the path (beyond the border or a hole)
+    const Coordinates& a = wall.m_coordinates;
+    const Coordinates b = (wall.m_orientation == Orientation::H) ? a.offset(0, -1) : a.offset(-1, 0);
+    auto onPath = [this](const Coordinates& c) { return std::find(m_coordinates.begin(), m_coordinates.end(), c) != m_coordinates.end(); };
+    for (auto end: {m_coordinates.front(), m_coordinates.back()})
     {
-        case Orientation::H:
-            // top border
-            if (wall.m_coordinates.y() == 0)
-            {
-                if (m_coordinates[0] == wall.m_coordinates || m_coordinates.back() == wall.m_coordinates)
-                {
-                    return true;
-                }
-            }
-            // bottom border
-            else if (wall.m_coordinates.y() == maxY + 1)
-            {
-                if (m_coordinates[0].y() == maxY && m_coordinates[0].x() == wall.m_coordinates.x())
-                {
-                    return true;
-                }
-                else if (m_coordinates.back().y() == maxY && m_coordinates.back().x() == wall.m_coordinates.x())
-                {
-                    return true;
-                }
-            }
-            break;
-            
-        case Orientation::V:
-            // left border
-            if (wall.m_coordinates.x() == 0)
-            {
-                if (m_coordinates[0] == wall.m_coordinates || m_coordinates.back() == wall.m_coordinates)
-                {
-                    return true;
-                }
-            }
-            // right border
-            else if (wall.m_coordinates.x() == maxX + 1)
-            {
-                if (m_coordinates[0].x() == maxX && m_coordinates[0].y() == wall.m_coordinates.y())
-                {
-                    return true;
-                }
-                else if (m_coordinates.back().x() == maxX && m_coordinates.back().y() == wall.m_coordinates.y())
-                {
-                    return true;
-                }
-            }
-            break;
+        if ((end == a && !onPath(b)) || (end == b && !onPath(a)))
+        {
+            return true;
+        }
     }
     
     for (unsigned int i = 0; i + 1 < m_coordinates.size(); ++i)
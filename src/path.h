@@ -27,6 +27,7 @@
 #include <set>
 #include <vector>
 #include "coordinates.h"
+#include "symmetry.h"
 #include "wall.h"
 
 class Path
@@ -41,6 +42,11 @@ class Path
         const Coordinates& at(int index) const { return m_coordinates.at(index); }
         void set(int index, const Coordinates& c) { m_coordinates.at(index) = c; }
         
+        Path transformed(Transform t, int width, int height) const;
+        Path reversed() const;
+        // same fields in the same or reverse order
+        bool isEquivalent(const Path& other) const;
+        
         bool isBlockedBy(const Wall& wall) const;
         std::vector<Wall> getNonblockingWalls(const std::vector<Wall>& walls) const;
         std::vector<Wall> getBlockingWalls(const std::set<Wall>& walls) const;
@@ -0,0 +1,265 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "board.h"
+#include "geometry.h"
+#include "pathCounter.h"
+
+namespace
+{
+    // frontier slots 0..width-1: fragment ending in the edge from a processed field down to the unprocessed
+    // field below; slot width: edge from the previous field of the current line to the current field.
+    // Slot values are fragment labels (0 = no edge), 4 bits each. A label occurring twice marks both open
+    // ends of a fragment, a label occurring once a fragment whose other end is the entry or exit.
+    typedef std::array<int, maxPathCountWidth + 1> Slots;
+
+    uint64_t encode(const Slots& slots, int size)
+    {
+        // labels are renumbered in order of first occurrence, so equivalent states get the same key
+        std::array<int, maxPathCountWidth + 2> relabel;
+        relabel.fill(0);
+        int next = 0;
+        uint64_t key = 0;
+        for (int i = 0; i < size; ++i)
+        {
+            int label = slots[i];
+            if (label != 0)
+            {
+                if (relabel[label] == 0)
+                {
+                    relabel[label] = ++next;
+                }
+                label = relabel[label];
+            }
+            key |= static_cast<uint64_t>(label) << (4 * i);
+        }
+        return key;
+    }
+
+    void decode(uint64_t key, int size, Slots& slots)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            slots[i] = (key >> (4 * i)) & 0xf;
+        }
+    }
+}
+
+
+bool countPaths(const Board& board, PathCount& count)
+{
+    count = 0;
+    const int w = board.width();
+    const int h = board.height();
+    if (w == 0 || h == 0)
+    {
+        return true;
+    }
+
+    // lines run along the longer side, the frontier spans the shorter one
+    const bool transposed = h < w;
+    const int width = transposed ? h : w;
+    const int lines = transposed ? w : h;
+    if (width > maxPathCountWidth)
+    {
+        return false;
+    }
+    auto field = [transposed](int column, int line) { return transposed ? Coordinates(line, column) : Coordinates(column, line); };
+    auto isOpen = [&board](const Coordinates& a, const Coordinates& b)
+    {
+        if (board.isHole(a) || board.isHole(b))
+        {
+            return false;
+        }
+        return (a.y() == b.y())
+            ? !board.hasWall(Wall({std::max(a.x(), b.x()), a.y()}, Orientation::V))
+            : !board.hasWall(Wall({a.x(), std::max(a.y(), b.y())}, Orientation::H));
+    };
+    const Geometry geometry(w, h, board.holes());
+    auto isEdgeOpen = [&board, &geometry](const Coordinates& c)
+    {
+        const std::vector<Wall> walls = borderWalls(geometry, geometry.c2f(c));
+        return std::any_of(walls.begin(), walls.end(), [&board](const Wall& wall) { return !board.hasWall(wall); });
+    };
+    // the path is completed at the last field that is not a hole
+    int lastField = lines * width - 1;
+    while (lastField > 0 && board.isHole(field(lastField % width, lastField / width)))
+    {
+        --lastField;
+    }
+
+    const int size = width + 1;
+    std::unordered_map<uint64_t, PathCount> states;
+    std::unordered_map<uint64_t, PathCount> nextStates;
+    states[0] = 1;
+    Slots slots;
+    Slots out;
+    for (int line = 0; line < lines; ++line)
+    {
+        for (int column = 0; column < width; ++column)
+        {
+            const Coordinates c = field(column, line);
+            if (board.isHole(c))
+            {
+                // no edges into a hole, the frontier passes unchanged
+                continue;
+            }
+            const bool isLast = (line * width + column == lastField);
+            const bool canRight = (column + 1 < width) && isOpen(c, field(column + 1, line));
+            const bool canDown = (line + 1 < lines) && isOpen(c, field(column, line + 1));
+            const bool canEnd = isEdgeOpen(c);
+
+            nextStates.clear();
+            for (const auto& state: states)
+            {
+                decode(state.first, size, slots);
+                const int up = slots[column];
+                const int left = slots[width];
+                int occurrences[maxPathCountWidth + 2] = {0};
+                int fresh = 1;
+                for (int i = 0; i < size; ++i)
+                {
+                    ++occurrences[slots[i]];
+                    fresh = std::max(fresh, slots[i] + 1);
+                }
+                int ends = 0;
+                for (int label = 1; label < fresh; ++label)
+                {
+                    ends += (occurrences[label] == 1) ? 1 : 0;
+                }
+                auto isOnly = [&](int a, int b)
+                {
+                    // no fragment besides a and b is left in the frontier
+                    for (int i = 0; i < size; ++i)
+                    {
+                        if (slots[i] != 0 && slots[i] != a && slots[i] != b)
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+
+                for (int right = 0; right <= (canRight ? 1 : 0); ++right)
+                {
+                    for (int down = 0; down <= (canDown ? 1 : 0); ++down)
+                    {
+                        const int degree = (up != 0) + (left != 0) + right + down;
+                        if (degree == 0 || degree > 2 || (degree == 1 && !canEnd))
+                        {
+                            continue;
+                        }
+                        out = slots;
+                        out[column] = 0;
+                        out[width] = 0;
+                        int newEnds = ends;
+                        if (up != 0 && left != 0)
+                        {
+                            if (up == left)
+                            {
+                                // would close a cycle
+                                continue;
+                            }
+                            if (occurrences[up] == 1 && occurrences[left] == 1)
+                            {
+                                // joins the fragments from entry and exit: complete path
+                                if (isLast && isOnly(up, left))
+                                {
+                                    count += state.second;
+                                }
+                                continue;
+                            }
+                            std::replace(out.begin(), out.begin() + size, left, up);
+                        }
+                        else if (up != 0 || left != 0)
+                        {
+                            const int label = (up != 0) ? up : left;
+                            if (degree == 1)
+                            {
+                                // fragment ends here at the entry or exit
+                                if (occurrences[label] == 1)
+                                {
+                                    if (isLast && isOnly(label, label))
+                                    {
+                                        count += state.second;
+                                    }
+                                    continue;
+                                }
+                                ++newEnds;
+                            }
+                            else
+                            {
+                                out[right ? width : column] = label;
+                            }
+                        }
+                        else
+                        {
+                            // new fragment starting here, either with two open ends or at the entry or exit
+                            if (degree == 1)
+                            {
+                                ++newEnds;
+                            }
+                            if (right)
+                            {
+                                out[width] = fresh;
+                            }
+                            if (down)
+                            {
+                                out[column] = fresh;
+                            }
+                        }
+                        if (newEnds > 2)
+                        {
+                            continue;
+                        }
+                        nextStates[encode(out, size)] += state.second;
+                    }
+                }
+            }
+            std::swap(states, nextStates);
+        }
+    }
+
+    return true;
+}
+
+
+std::string toString(PathCount count)
+{
+    std::string s;
+    do
+    {
+        s.push_back('0' + static_cast<int>(count % 10));
+        count /= 10;
+    }
+    while (count != 0);
+    std::reverse(s.begin(), s.end());
+    return s;
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <string>
+
+class Board;
+
+// exact number of solutions; large boards easily exceed 64 bits
+typedef unsigned __int128 PathCount;
+
+// Counts the solution paths of a board (field sequences from an open edge
+// field to another one, each path counted once regardless of direction).
+//
+// Frontier-based dynamic programming: the fields are processed line by line
+// along the longer side of the board, and a state is the set of path fragments
+// crossing the frontier between processed and unprocessed fields (which
+// frontier edges are used and which of them are connected). The number of
+// states is exponential in the shorter side only, so boards up to about 10
+// fields wide are counted in seconds regardless of their length (an empty
+// 10x10 board takes a few seconds, 12x12 well over half a minute). Returns
+// false if the shorter side exceeds maxPathCountWidth.
+// bench/pathCountCheck.cpp compares the counts against brute force.
+const int maxPathCountWidth = 14;
+bool countPaths(const Board& board, PathCount& count);
+
+std::string toString(PathCount count);
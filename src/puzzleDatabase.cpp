@@ -0,0 +1,623 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "geometry.h"
+#include "puzzleDatabase.h"
+
+namespace
+{
+    const char magic[8] = {'A', 'L', 'C', 'Z', 'P', 'D', 'B', '1'};
+    const unsigned int version = 1;
+    const int headerSize = 32;
+    const int recordHeaderSize = 24;
+    const int groupSize = 32;
+
+    uint64_t readInt(const uint8_t* p, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    void writeInt(std::string& buffer, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+        {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    int cellBytes(int width, int height)
+    {
+        return (width * height <= 256) ? 1 : 2;
+    }
+
+    uint64_t recordSize(const Board& board, bool hasPath)
+    {
+        const int fields = board.width() * board.height();
+        return recordHeaderSize + (board.wallCount() + 7) / 8 + (board.holes().empty() ? 0 : (fields + 7) / 8)
+            + (hasPath ? board.fieldCount() * cellBytes(board.width(), board.height()) : 0);
+    }
+
+    // rewrites the records and a fresh index into a temporary file, which then replaces the database
+    bool compact(const std::string& fileName)
+    {
+        const std::string compactFile = fileName + ".compact";
+        std::remove(compactFile.c_str());
+
+        PuzzleDatabase db;
+        PuzzleDatabaseWriter writer;
+        bool ok = db.open(fileName) && writer.open(compactFile);
+        for (uint64_t i = 0; ok && i < db.size(); ++i)
+        {
+            const PuzzleRecord record = db.get(i);
+            ok = record.board.width() != 0 && writer.add(record);
+        }
+        ok = writer.close() && ok;
+        db.close();
+        if (!ok || std::rename(compactFile.c_str(), fileName.c_str()) != 0)
+        {
+            std::remove(compactFile.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+
+bool PuzzleDatabase::isDatabase(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    char buffer[sizeof(magic)];
+    return file.read(buffer, sizeof(buffer)) && std::memcmp(buffer, magic, sizeof(magic)) == 0;
+}
+
+
+bool PuzzleDatabase::open(const std::string& fileName)
+{
+    close();
+
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < headerSize)
+    {
+        ::close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_fileSize = st.st_size;
+    m_count = readInt(m_data + 16, 8);
+    m_indexOffset = readInt(m_data + 24, 8);
+
+    // bound every count by the file size first, so that the offsets below cannot overflow
+    if (std::memcmp(m_data, magic, sizeof(magic)) != 0 || readInt(m_data + 8, 4) != version ||
+        m_indexOffset < headerSize || m_indexOffset > m_fileSize || m_count > (m_fileSize - headerSize) / 8)
+    {
+        close();
+        return false;
+    }
+    const uint64_t groupsOffset = m_indexOffset + 8 * m_count;
+    if (groupsOffset + 8 > m_fileSize)
+    {
+        close();
+        return false;
+    }
+    m_groupCount = readInt(m_data + groupsOffset, 8);
+    if (m_groupCount > m_fileSize / groupSize || groupsOffset + 8 + groupSize * m_groupCount + 8 * m_count > m_fileSize)
+    {
+        close();
+        return false;
+    }
+
+    // the groups have to partition the puzzle indexes
+    const uint8_t* groups = m_data + groupsOffset + 8;
+    const uint8_t* entries = groups + groupSize * m_groupCount;
+    for (uint64_t i = 0; i < m_groupCount; ++i)
+    {
+        const uint64_t first = readInt(groups + groupSize * i + 16, 8);
+        const uint64_t count = readInt(groups + groupSize * i + 24, 8);
+        if (first > m_count || count > m_count - first)
+        {
+            close();
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < m_count; ++i)
+    {
+        if (readInt(entries + 8 * i, 8) >= m_count)
+        {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void PuzzleDatabase::close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_fileSize);
+    }
+    m_data = nullptr;
+    m_fileSize = 0;
+    m_count = 0;
+    m_indexOffset = 0;
+    m_groupCount = 0;
+}
+
+
+PuzzleRecord PuzzleDatabase::get(uint64_t index) const
+{
+    PuzzleRecord record;
+    if (index >= m_count)
+    {
+        return record;
+    }
+
+    // a record has to lie completely within the file, otherwise the result is an empty board
+    const uint64_t offset = readInt(m_data + m_indexOffset + 8 * index, 8);
+    if (offset < headerSize || offset > m_fileSize || m_fileSize - offset < recordHeaderSize)
+    {
+        return record;
+    }
+    const uint8_t* p = m_data + offset;
+    const int width = p[0];
+    const int height = p[1];
+    const bool hasPath = (p[2] & 1) != 0;
+    const bool hasHoles = (p[2] & 2) != 0;
+    if (width < 1 || height < 1)
+    {
+        return record;
+    }
+    const uint64_t fixedSize = recordHeaderSize + (Board(width, height).wallCount() + 7) / 8 + (hasHoles ? (width * height + 7) / 8 : 0);
+    if (m_fileSize - offset < fixedSize)
+    {
+        return record;
+    }
+    record.seed = readInt(p + 4, 4);
+    record.templateHash = readInt(p + 8, 8);
+    record.solveCalls = readInt(p + 16, 4);
+    record.milliseconds = readInt(p + 20, 4);
+    p += recordHeaderSize;
+
+    record.board = Board(width, height);
+    const int walls = record.board.wallCount();
+    for (int i = 0; i < walls; ++i)
+    {
+        if (p[i / 8] & (1 << (i % 8)))
+        {
+            record.board.addWall(record.board.wall(i));
+        }
+    }
+    p += (walls + 7) / 8;
+
+    if (hasHoles)
+    {
+        for (int i = 0; i < width * height; ++i)
+        {
+            if (p[i / 8] & (1 << (i % 8)))
+            {
+                record.board.addHole(record.board.coord(i));
+            }
+        }
+        p += (width * height + 7) / 8;
+    }
+
+    if (hasPath)
+    {
+        const int bytes = cellBytes(width, height);
+        const int pathLength = record.board.fieldCount();
+        if (m_fileSize - offset - fixedSize < static_cast<uint64_t>(bytes * pathLength))
+        {
+            return PuzzleRecord();
+        }
+        record.solution = Path(pathLength);
+        for (int pos = 0; pos < pathLength; ++pos)
+        {
+            record.solution.set(pos, record.board.coord(readInt(p + bytes * pos, bytes)));
+        }
+    }
+
+    return record;
+}
+
+
+uint64_t PuzzleDatabase::recordSize(uint64_t index) const
+{
+    if (index >= m_count)
+    {
+        return 0;
+    }
+    const uint64_t offset = readInt(m_data + m_indexOffset + 8 * index, 8);
+    if (offset < headerSize || offset > m_fileSize || m_fileSize - offset < recordHeaderSize)
+    {
+        return 0;
+    }
+    const uint8_t* p = m_data + offset;
+    const int width = p[0];
+    const int height = p[1];
+    const bool hasPath = (p[2] & 1) != 0;
+    const bool hasHoles = (p[2] & 2) != 0;
+    if (width < 1 || height < 1)
+    {
+        return 0;
+    }
+    uint64_t size = recordHeaderSize + (wallCount(width, height) + 7) / 8;
+    int pathLength = width * height;
+    if (hasHoles)
+    {
+        const uint8_t* holes = p + size;
+        size += (width * height + 7) / 8;
+        if (m_fileSize - offset < size)
+        {
+            return 0;
+        }
+        for (int i = 0; i < width * height; ++i)
+        {
+            if (holes[i / 8] & (1 << (i % 8)))
+            {
+                --pathLength;
+            }
+        }
+    }
+    if (hasPath)
+    {
+        size += pathLength * cellBytes(width, height);
+    }
+    return (m_fileSize - offset < size) ? 0 : size;
+}
+
+
+std::vector<uint64_t> PuzzleDatabase::find(int width, int height, uint64_t templateHash) const
+{
+    const uint8_t* groups = m_data + m_indexOffset + 8 * m_count + 8;
+    const uint8_t* entries = groups + groupSize * m_groupCount;
+    const auto key = std::make_tuple(width, height, templateHash);
+
+    // binary search over the sorted group table
+    uint64_t lo = 0;
+    uint64_t hi = m_groupCount;
+    while (lo < hi)
+    {
+        const uint64_t mid = (lo + hi) / 2;
+        const uint8_t* g = groups + groupSize * mid;
+        const auto midKey = std::make_tuple(static_cast<int>(g[0]), static_cast<int>(g[1]), readInt(g + 8, 8));
+        if (midKey < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    std::vector<uint64_t> result;
+    if (lo < m_groupCount)
+    {
+        const uint8_t* g = groups + groupSize * lo;
+        if (g[0] == width && g[1] == height && readInt(g + 8, 8) == templateHash)
+        {
+            const uint64_t first = readInt(g + 16, 8);
+            const uint64_t count = readInt(g + 24, 8);
+            for (uint64_t i = first; i < first + count; ++i)
+            {
+                result.push_back(readInt(entries + 8 * i, 8));
+            }
+        }
+    }
+    return result;
+}
+
+
+bool PuzzleDatabaseWriter::open(const std::string& fileName)
+{
+    close();
+
+    std::ifstream probe(fileName, std::ios::binary | std::ios::ate);
+    const bool exists = probe && probe.tellg() > 0;
+    probe.close();
+
+    if (exists)
+    {
+        // keep the existing records and index; new records go behind the old index, which stays valid
+        // (and the header pointing to it) until close() has written the new index
+        PuzzleDatabase db;
+        if (!db.open(fileName))
+        {
+            std::cout << "Error: '" << fileName << "' is not a puzzle database" << std::endl;
+            return false;
+        }
+
+        for (uint64_t i = 0; i < db.size(); ++i)
+        {
+            m_offsets.push_back(readInt(db.m_data + db.m_indexOffset + 8 * i, 8));
+            m_recordBytes += db.recordSize(i);
+        }
+        const uint8_t* groups = db.m_data + db.m_indexOffset + 8 * db.m_count + 8;
+        const uint8_t* entries = groups + groupSize * db.m_groupCount;
+        for (uint64_t i = 0; i < db.m_groupCount; ++i)
+        {
+            const uint8_t* g = groups + groupSize * i;
+            auto& ids = m_groups[std::make_tuple(static_cast<int>(g[0]), static_cast<int>(g[1]), readInt(g + 8, 8))];
+            for (uint64_t e = readInt(g + 16, 8); e < readInt(g + 16, 8) + readInt(g + 24, 8); ++e)
+            {
+                ids.push_back(readInt(entries + 8 * e, 8));
+            }
+        }
+        m_offset = db.m_fileSize;
+        db.close();
+
+        m_file.open(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    }
+    else
+    {
+        m_file.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+        m_file.write(std::string(headerSize, '\0').data(), headerSize);
+        m_offset = headerSize;
+    }
+
+    if (!m_file)
+    {
+        return false;
+    }
+    m_fileName = fileName;
+    m_file.seekp(m_offset);
+    return true;
+}
+
+
+bool PuzzleDatabaseWriter::add(const PuzzleRecord& record)
+{
+    const Board& board = record.board;
+    const int width = board.width();
+    const int height = board.height();
+    if (!m_file.is_open() || width < 1 || height < 1 || width > 255 || height > 255)
+    {
+        return false;
+    }
+    const bool hasPath = record.solution.size() == static_cast<unsigned int>(board.fieldCount());
+    const bool hasHoles = !board.holes().empty();
+
+    std::string buffer;
+    writeInt(buffer, width, 1);
+    writeInt(buffer, height, 1);
+    writeInt(buffer, (hasPath ? 1 : 0) | (hasHoles ? 2 : 0), 1);
+    writeInt(buffer, 0, 1);
+    writeInt(buffer, record.seed, 4);
+    writeInt(buffer, record.templateHash, 8);
+    writeInt(buffer, record.solveCalls, 4);
+    writeInt(buffer, record.milliseconds, 4);
+
+    std::string bits((board.wallCount() + 7) / 8, '\0');
+    for (auto wall: board.walls())
+    {
+        const int i = board.wallIndex(wall);
+        bits[i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+    buffer += bits;
+
+    if (hasHoles)
+    {
+        std::string holes((width * height + 7) / 8, '\0');
+        for (int i = 0; i < width * height; ++i)
+        {
+            if (board.holes()[i])
+            {
+                holes[i / 8] |= static_cast<char>(1 << (i % 8));
+            }
+        }
+        buffer += holes;
+    }
+
+    if (hasPath)
+    {
+        const int bytes = cellBytes(width, height);
+        for (unsigned int pos = 0; pos < record.solution.size(); ++pos)
+        {
+            writeInt(buffer, board.index(record.solution.at(pos)), bytes);
+        }
+    }
+
+    m_file.write(buffer.data(), buffer.size());
+    if (!m_file)
+    {
+        return false;
+    }
+
+    m_groups[std::make_tuple(width, height, record.templateHash)].push_back(m_offsets.size());
+    m_offsets.push_back(m_offset);
+    const uint64_t size = recordSize(board, hasPath);
+    m_offset += size;
+    m_recordBytes += size;
+    return true;
+}
+
+
+bool PuzzleDatabaseWriter::close()
+{
+    if (!m_file.is_open())
+    {
+        return true;
+    }
+
+    std::string buffer;
+    for (auto offset: m_offsets)
+    {
+        writeInt(buffer, offset, 8);
+    }
+    writeInt(buffer, m_groups.size(), 8);
+    uint64_t first = 0;
+    for (auto group: m_groups)
+    {
+        writeInt(buffer, std::get<0>(group.first), 1);
+        writeInt(buffer, std::get<1>(group.first), 1);
+        writeInt(buffer, 0, 2);
+        writeInt(buffer, 0, 4);
+        writeInt(buffer, std::get<2>(group.first), 8);
+        writeInt(buffer, first, 8);
+        writeInt(buffer, group.second.size(), 8);
+        first += group.second.size();
+    }
+    for (auto group: m_groups)
+    {
+        for (auto id: group.second)
+        {
+            writeInt(buffer, id, 8);
+        }
+    }
+    m_file.seekp(m_offset);
+    m_file.write(buffer.data(), buffer.size());
+    m_file.flush();
+
+    // only a complete index replaces the old one
+    std::string header(magic, sizeof(magic));
+    writeInt(header, version, 4);
+    writeInt(header, 0, 4);
+    writeInt(header, m_offsets.size(), 8);
+    writeInt(header, m_offset, 8);
+    m_file.seekp(0);
+    m_file.write(header.data(), header.size());
+
+    const bool ok = static_cast<bool>(m_file);
+    m_file.close();
+
+    // appends leave the superseded indexes behind, reclaim them once they outweigh the records
+    const uint64_t deadBytes = m_offset - headerSize - m_recordBytes;
+    if (ok && deadBytes > m_recordBytes && !compact(m_fileName))
+    {
+        std::cout << "Error: cannot compact puzzle database '" << m_fileName << "'" << std::endl;
+    }
+
+    m_fileName.clear();
+    m_offset = 0;
+    m_recordBytes = 0;
+    m_offsets.clear();
+    m_groups.clear();
+    return ok;
+}
+
+
+bool convertPuzzles(const std::string& inputFile, const std::string& outputFile)
+{
+    unsigned int count = 0;
+    if (PuzzleDatabase::isDatabase(inputFile))
+    {
+        PuzzleDatabase db;
+        if (!db.open(inputFile))
+        {
+            std::cout << "Error: cannot open puzzle database '" << inputFile << "'" << std::endl;
+            return false;
+        }
+        std::ofstream file(outputFile);
+        if (!file)
+        {
+            std::cout << "Error: cannot open '" << outputFile << "' for writing" << std::endl;
+            return false;
+        }
+        for (uint64_t i = 0; i < db.size(); ++i, ++count)
+        {
+            const PuzzleRecord record = db.get(i);
+            if (record.board.width() == 0)
+            {
+                std::cout << "Error: puzzle database '" << inputFile << "' is corrupt at record #" << i << std::endl;
+                return false;
+            }
+            record.board.print(file, record.solution);
+            file << "\n";
+        }
+    }
+    else
+    {
+        std::ifstream file(inputFile);
+        if (!file)
+        {
+            std::cout << "Error: cannot open '" << inputFile << "' for reading" << std::endl;
+            return false;
+        }
+        PuzzleDatabaseWriter db;
+        if (!db.open(outputFile))
+        {
+            std::cout << "Error: cannot open puzzle database '" << outputFile << "' for writing" << std::endl;
+            return false;
+        }
+        PuzzleRecord record;
+        int line = 0;
+        std::string error;
+        while (true)
+        {
+            if (!record.board.parse(file, record.solution, &line, &error))
+            {
+                if (error.empty())
+                {
+                    break;
+                }
+                // a malformed board must not silently cut off the rest of the input
+                std::cout << "Error: malformed board in '" << inputFile << "' at line " << line << ": " << error << std::endl;
+                return false;
+            }
+            if (!db.add(record))
+            {
+                std::cout << "Error: cannot write puzzle database '" << outputFile << "'" << std::endl;
+                return false;
+            }
+            ++count;
+        }
+        if (!db.close())
+        {
+            std::cout << "Error: cannot write puzzle database '" << outputFile << "'" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "Info: converted " << count << " puzzles" << std::endl;
+    return true;
+}
@@ -0,0 +1,125 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "board.h"
+#include "path.h"
+
+// Binary puzzle database layout (all integers little endian):
+//
+//   header:  "ALCZPDB1", u32 version, u32 reserved, u64 count, u64 indexOffset
+//   records: u8 width, u8 height, u8 flags, u8 reserved, u32 seed,
+//            u64 templateHash, u32 solveCalls, u32 milliseconds,
+//            wall bitset (see Board::wallIndex), hole bitset (row major;
+//            only if flags & 2), solution path as cell indices
+//            (u8 if width*height <= 256, else u16; only if flags & 1)
+//   index:   u64 recordOffset[count],
+//            u64 groupCount, groups sorted by (width, height, templateHash):
+//              u8 width, u8 height, u16 reserved, u32 reserved,
+//              u64 templateHash, u64 firstEntry, u64 entryCount
+//            u64 puzzleIndex[count] (grouped)
+//
+// Appending writes the new records behind the old index and the new index
+// behind them; the header is updated last, so an interrupted append leaves
+// the previous database intact. The superseded index remains as dead bytes
+// until they outweigh the records: then the writer rewrites the database
+// into "FILE.compact" and renames it to FILE.
+
+struct PuzzleRecord
+{
+    Board board;
+    Path solution;
+    unsigned int seed = 0;
+    uint64_t templateHash = 0;
+    unsigned int solveCalls = 0;
+    unsigned int milliseconds = 0;
+};
+
+
+class PuzzleDatabase
+{
+    public:
+        PuzzleDatabase() = default;
+        PuzzleDatabase(const PuzzleDatabase&) = delete;
+        PuzzleDatabase& operator=(const PuzzleDatabase&) = delete;
+        ~PuzzleDatabase() { close(); }
+
+        static bool isDatabase(const std::string& fileName);
+
+        bool open(const std::string& fileName);
+        void close();
+
+        uint64_t size() const { return m_count; }
+        // a record with an empty board if the record does not lie within the file
+        PuzzleRecord get(uint64_t index) const;
+        // bytes of the stored record, 0 if it does not lie within the file
+        uint64_t recordSize(uint64_t index) const;
+        std::vector<uint64_t> find(int width, int height, uint64_t templateHash) const;
+
+    private:
+        friend class PuzzleDatabaseWriter;
+
+        const uint8_t* m_data = nullptr;
+        uint64_t m_fileSize = 0;
+        uint64_t m_count = 0;
+        uint64_t m_indexOffset = 0;
+        uint64_t m_groupCount = 0;
+};
+
+
+class PuzzleDatabaseWriter
+{
+    public:
+        PuzzleDatabaseWriter() = default;
+        PuzzleDatabaseWriter(const PuzzleDatabaseWriter&) = delete;
+        PuzzleDatabaseWriter& operator=(const PuzzleDatabaseWriter&) = delete;
+        ~PuzzleDatabaseWriter() { close(); }
+
+        // appends to an existing database, creates a new one otherwise
+        bool open(const std::string& fileName);
+        bool add(const PuzzleRecord& record);
+        bool close();
+
+    private:
+        typedef std::tuple<int, int, uint64_t> GroupKey;
+
+        std::fstream m_file;
+        std::string m_fileName;
+        uint64_t m_offset = 0;
+        // bytes of all records, the rest behind the header up to m_offset is dead
+        uint64_t m_recordBytes = 0;
+        std::vector<uint64_t> m_offsets;
+        std::map<GroupKey, std::vector<uint64_t>> m_groups;
+};
+
+
+// converts ASCII boards (as written by Board::print) into a database and vice versa
+bool convertPuzzles(const std::string& inputFile, const std::string& outputFile);
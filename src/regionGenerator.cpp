@@ -0,0 +1,456 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "regionGenerator.h"
+#include "templateBoard.h"
+
+
+RegionGenerator::RegionGenerator(int width, int height, unsigned int seed, int regionSize, unsigned int threads) :
+    m_width(width),
+    m_height(height),
+    m_regionSize(regionSize),
+    m_threads(threads)
+{
+    if (seed == 0)
+    {
+        seed = std::random_device()();
+    }
+    m_seed = seed;
+    m_rng.seed(seed);
+    if (m_threads == 0)
+    {
+        m_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+
+std::vector<int> RegionGenerator::split(int length, int target, int oddPart)
+{
+    const int parts = std::max(1, std::min((length + target / 2) / target, length / 4));
+    const int even = length - (length & 1);
+    std::vector<int> result(parts, (even / 2 / parts) * 2);
+    for (int i = 0, rest = even - result[0] * parts; rest > 0; ++i, rest -= 2)
+    {
+        result[i] += 2;
+    }
+    if (length & 1)
+    {
+        result[(oddPart < 0 || oddPart >= parts) ? parts - 1 : oddPart] += 1;
+    }
+    return result;
+}
+
+
+Board RegionGenerator::get()
+{
+    std::cout << "Info: using seed " << m_seed << std::endl;
+    const auto startTime = std::chrono::steady_clock::now();
+    m_stats = GeneratorStats();
+    m_solution = Path();
+    m_regions.clear();
+
+    if (m_width < 4 || m_height < 4)
+    {
+        std::cout << "Error: region mode needs a board of at least 4x4" << std::endl;
+        return Board();
+    }
+
+    // only the last region (in serpentine order) may have an odd number of fields
+    const int rows = split(m_height, m_regionSize, 0).size();
+    const std::vector<int> rowHeights = split(m_height, m_regionSize, rows - 1);
+    const int columns = split(m_width, m_regionSize, 0).size();
+    const std::vector<int> columnWidths = split(m_width, m_regionSize, (rows % 2 == 1) ? columns - 1 : 0);
+    for (int row = 0, y0 = 0; row < rows; y0 += rowHeights[row], ++row)
+    {
+        std::vector<Region> rowRegions;
+        for (int column = 0, x0 = 0; column < columns; x0 += columnWidths[column], ++column)
+        {
+            Region region;
+            region.x0 = x0;
+            region.y0 = y0;
+            region.width = columnWidths[column];
+            region.height = rowHeights[row];
+            rowRegions.push_back(region);
+        }
+        if (row % 2 == 1)
+        {
+            std::reverse(rowRegions.begin(), rowRegions.end());
+        }
+        m_regions.insert(m_regions.end(), rowRegions.begin(), rowRegions.end());
+    }
+    std::cout << "Info: splitting board into " << columns << "x" << rows << " regions" << std::endl;
+
+    // all in-fields have the same colour; an odd region needs both of its doors on its majority colour
+    const Region& last = m_regions.back();
+    if ((last.width * last.height) % 2 == 1)
+    {
+        m_inColour = colour({last.x0, last.y0});
+    }
+    else
+    {
+        m_inColour = std::uniform_int_distribution<int>(0, 1)(m_rng);
+    }
+    for (int door = 0; door <= static_cast<int>(m_regions.size()); ++door)
+    {
+        chooseDoor(door);
+    }
+
+    // regenerate failed regions with other doors (which changes their neighbours as well)
+    for (int round = 0; !generateRegions(); ++round)
+    {
+        if (round >= 10)
+        {
+            std::cout << "Error: cannot generate all regions" << std::endl;
+            return Board();
+        }
+        std::vector<int> failed;
+        for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+        {
+            if (!m_regions[i].done)
+            {
+                failed.push_back(i);
+            }
+        }
+        for (auto i: failed)
+        {
+            chooseDoor(i);
+            chooseDoor(i + 1);
+            for (int j = std::max(0, i - 1); j <= std::min<int>(i + 1, m_regions.size() - 1); ++j)
+            {
+                m_regions[j].done = false;
+            }
+        }
+    }
+
+    // stitch regions
+    Board b(m_width, m_height);
+    m_solution = Path(m_width * m_height);
+    int length = 0;
+    for (const auto& region: m_regions)
+    {
+        for (auto wall: region.walls)
+        {
+            b.addWall(wall);
+        }
+        for (unsigned int pos = 0; pos < region.path.size(); ++pos)
+        {
+            m_solution.set(length++, region.path.at(pos));
+        }
+    }
+
+    if (!verify(b, m_solution))
+    {
+        std::cout << "Error: stitched regions do not form a valid board" << std::endl;
+        m_solution = Path();
+        return Board();
+    }
+    std::cout << "Info: board is uniquely solvable since all " << m_regions.size() << " regions are" << std::endl;
+
+    m_stats.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    return b;
+}
+
+
+void RegionGenerator::chooseDoor(int i)
+{
+    const int count = m_regions.size();
+    std::vector<Opening> candidates;
+    auto add = [&candidates](const Coordinates& field, const Wall& wall)
+    {
+        Opening opening;
+        opening.field = field;
+        opening.wall = wall;
+        candidates.push_back(opening);
+    };
+
+    if (i == 0)
+    {
+        // entry on the top or left border of the first (top left) region
+        const Region& r = m_regions[0];
+        for (int x = 0; x < r.width; ++x)
+        {
+            add({x, 0}, Wall({x, 0}, Orientation::H));
+        }
+        for (int y = 0; y < r.height; ++y)
+        {
+            add({0, y}, Wall({0, y}, Orientation::V));
+        }
+    }
+    else if (i == count)
+    {
+        // exit on the outer border of the last region
+        const Region& r = m_regions[count - 1];
+        for (int x = r.x0; x < r.x0 + r.width; ++x)
+        {
+            add({x, m_height - 1}, Wall({x, m_height}, Orientation::H));
+            if (r.y0 == 0)
+            {
+                add({x, 0}, Wall({x, 0}, Orientation::H));
+            }
+        }
+        for (int y = r.y0; y < r.y0 + r.height; ++y)
+        {
+            if (r.x0 == 0)
+            {
+                add({0, y}, Wall({0, y}, Orientation::V));
+            }
+            if (r.x0 + r.width == m_width)
+            {
+                add({m_width - 1, y}, Wall({m_width, y}, Orientation::V));
+            }
+        }
+    }
+    else
+    {
+        // field of region i next to region i-1
+        const Region& prev = m_regions[i - 1];
+        const Region& r = m_regions[i];
+        if (prev.y0 == r.y0)
+        {
+            const int x = (prev.x0 < r.x0) ? r.x0 : r.x0 + r.width - 1;
+            const int wallX = (prev.x0 < r.x0) ? r.x0 : r.x0 + r.width;
+            for (int y = r.y0; y < r.y0 + r.height; ++y)
+            {
+                add({x, y}, Wall({wallX, y}, Orientation::V));
+            }
+        }
+        else
+        {
+            for (int x = r.x0; x < r.x0 + r.width; ++x)
+            {
+                add({x, r.y0}, Wall({x, r.y0}, Orientation::H));
+            }
+        }
+    }
+
+    // in-fields (region i side of door i) have m_inColour, the exit has the other colour unless the last region is odd
+    const bool lastIsOdd = (m_regions.back().width * m_regions.back().height) % 2 == 1;
+    const int wanted = (i == count && !lastIsOdd) ? 1 - m_inColour : m_inColour;
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const Opening& o)
+        {
+            return colour(o.field) != wanted || (i == count && o.field == m_regions[count - 1].in.field);
+        }), candidates.end());
+
+    const Opening opening = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(m_rng)];
+    if (i < count)
+    {
+        m_regions[i].in = opening;
+    }
+    if (i == count)
+    {
+        m_regions[i - 1].out = opening;
+    }
+    else if (i > 0)
+    {
+        // the field on the other side of the door belongs to region i-1
+        Opening out = opening;
+        const Region& prev = m_regions[i - 1];
+        if (opening.wall.m_orientation == Orientation::V)
+        {
+            out.field = {(prev.x0 < opening.field.x()) ? opening.field.x() - 1 : opening.field.x() + 1, opening.field.y()};
+        }
+        else
+        {
+            out.field = {opening.field.x(), opening.field.y() - 1};
+        }
+        m_regions[i - 1].out = out;
+    }
+}
+
+
+bool RegionGenerator::generateRegions()
+{
+    std::vector<int> todo;
+    std::vector<unsigned int> seeds;
+    for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+    {
+        if (!m_regions[i].done)
+        {
+            todo.push_back(i);
+            seeds.push_back(m_rng() | 1);
+        }
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::size_t finished = m_regions.size() - todo.size();
+    std::mutex mutex;
+    auto worker = [&]()
+    {
+        for (std::size_t k = next++; k < todo.size(); k = next++)
+        {
+            Region& r = m_regions[todo[k]];
+
+            // closed region border, open doors
+            TemplateBoard t(r.width, r.height);
+            for (int x = 0; x < r.width; ++x)
+            {
+                t.setFixedClosed(Wall({x, 0}, Orientation::H));
+                t.setFixedClosed(Wall({x, r.height}, Orientation::H));
+            }
+            for (int y = 0; y < r.height; ++y)
+            {
+                t.setFixedClosed(Wall({0, y}, Orientation::V));
+                t.setFixedClosed(Wall({r.width, y}, Orientation::V));
+            }
+            for (auto opening: {r.in, r.out})
+            {
+                t.setFixedOpen(Wall(opening.wall.m_coordinates.offset(-r.x0, -r.y0), opening.wall.m_orientation));
+            }
+
+            Generator generator(t, seeds[k]);
+            generator.setVerbose(false);
+            generator.setLearnedClauseCache(m_learnedClauses);
+            generator.setEncoding(m_encoding);
+            generator.setBackboneCache(m_backbones);
+            const Board b = generator.get();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            m_stats.solveCalls += generator.stats().solveCalls;
+            r.done = (b.width() != 0);
+            r.walls.clear();
+            if (r.done)
+            {
+                for (auto wall: b.walls())
+                {
+                    r.walls.push_back(Wall(wall.m_coordinates.offset(r.x0, r.y0), wall.m_orientation));
+                }
+                r.path = Path(generator.solution().size());
+                for (unsigned int pos = 0; pos < generator.solution().size(); ++pos)
+                {
+                    r.path.set(pos, generator.solution().at(pos).offset(r.x0, r.y0));
+                }
+                if (!(r.path.at(0) == r.in.field))
+                {
+                    r.path = r.path.reversed();
+                }
+            }
+            std::cout << "\rInfo: generated regions " << ++finished << " of " << m_regions.size() << "                     " << std::flush;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < std::min<std::size_t>(m_threads, todo.size()); ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+    std::cout << std::endl;
+
+    return std::all_of(m_regions.begin(), m_regions.end(), [](const Region& r) { return r.done; });
+}
+
+
+bool RegionGenerator::verify(const Board& board, const Path& path) const
+{
+    if (static_cast<int>(path.size()) != m_width * m_height)
+    {
+        return false;
+    }
+
+    std::vector<int> regionOf(m_width * m_height, -1);
+    for (int i = 0; i < static_cast<int>(m_regions.size()); ++i)
+    {
+        const Region& r = m_regions[i];
+        for (int y = r.y0; y < r.y0 + r.height; ++y)
+        {
+            for (int x = r.x0; x < r.x0 + r.width; ++x)
+            {
+                regionOf[board.index(x, y)] = i;
+            }
+        }
+    }
+
+    // path visits every field once and does not cross walls
+    std::vector<bool> visited(m_width * m_height, false);
+    for (unsigned int pos = 0; pos < path.size(); ++pos)
+    {
+        const Coordinates& c = path.at(pos);
+        if (c.x() < 0 || c.y() < 0 || c.x() >= m_width || c.y() >= m_height || visited[board.index(c)])
+        {
+            return false;
+        }
+        visited[board.index(c)] = true;
+        if (pos > 0)
+        {
+            const Coordinates& p = path.at(pos - 1);
+            if (std::abs(p.x() - c.x()) + std::abs(p.y() - c.y()) != 1)
+            {
+                return false;
+            }
+            const Wall between = (p.y() == c.y())
+                ? Wall({std::max(p.x(), c.x()), c.y()}, Orientation::V)
+                : Wall({c.x(), std::max(p.y(), c.y())}, Orientation::H);
+            if (board.hasWall(between))
+            {
+                return false;
+            }
+        }
+    }
+
+    // outer border closed except entry and exit, walls between regions closed except the doors
+    std::set<Wall> doors;
+    for (const auto& region: m_regions)
+    {
+        doors.insert(region.in.wall);
+        doors.insert(region.out.wall);
+    }
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (int x = 0; x <= m_width; ++x)
+        {
+            const Wall wall({x, y}, Orientation::V);
+            const bool separating = (x == 0 || x == m_width || regionOf[board.index(x - 1, y)] != regionOf[board.index(x, y)]);
+            if (separating && !board.hasWall(wall) && doors.find(wall) == doors.end())
+            {
+                return false;
+            }
+        }
+    }
+    for (int y = 0; y <= m_height; ++y)
+    {
+        for (int x = 0; x < m_width; ++x)
+        {
+            const Wall wall({x, y}, Orientation::H);
+            const bool separating = (y == 0 || y == m_height || regionOf[board.index(x, y - 1)] != regionOf[board.index(x, y)]);
+            if (separating && !board.hasWall(wall) && doors.find(wall) == doors.end())
+            {
+                return false;
+            }
+        }
+    }
+
+    return path.at(0) == m_regions.front().in.field && path.at(path.size() - 1) == m_regions.back().out.field;
+}
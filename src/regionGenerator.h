@@ -0,0 +1,114 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "backbone.h"
+#include "board.h"
+#include "formula.h"
+#include "generator.h"
+#include "learnedClauseCache.h"
+#include "path.h"
+
+// Generates boards that are too large for a single SAT formula.
+//
+// The board is split into rectangular regions (about regionSize x regionSize
+// fields) that are chained in serpentine order. All walls between regions are
+// closed except one door between consecutive regions, and the outer border is
+// closed except an entry in the first and an exit in the last region. So every
+// path runs through the regions in chain order and covers each region in one
+// piece between its two doors, i.e. the board is uniquely solvable iff every
+// region is uniquely solvable between its doors. The regions are independent
+// boards, which are generated in parallel by Generator.
+//
+// Door positions respect the checkerboard colouring (region sizes are chosen
+// such that at most the last region has an odd number of fields), so every
+// region of at least 4x4 fields has a path between its doors.
+class RegionGenerator
+{
+    public:
+      RegionGenerator(int width, int height, unsigned int seed, int regionSize, unsigned int threads);
+
+      // passed on to the generators of all regions (see Generator)
+      void setLearnedClauseCache(LearnedClauseCache* cache) { m_learnedClauses = cache; }
+      void setEncoding(Encoding encoding) { m_encoding = encoding; }
+      void setBackboneCache(BackboneCache* cache) { m_backbones = cache; }
+
+      Board get();
+
+      unsigned int seed() const { return m_seed; }
+      const Path& solution() const { return m_solution; }
+      const GeneratorStats& stats() const { return m_stats; }
+
+    private:
+      // field of a region next to a door, and the wall of the door
+      struct Opening
+      {
+          Coordinates field;
+          Wall wall = Wall({0, 0}, Orientation::H);
+      };
+
+      struct Region
+      {
+          int x0 = 0;
+          int y0 = 0;
+          int width = 0;
+          int height = 0;
+          Opening in;
+          Opening out;
+          Path path;
+          std::vector<Wall> walls;
+          bool done = false;
+      };
+
+      // splits length into parts of about target (at least 4) with even sizes, except for oddPart if length is odd
+      static std::vector<int> split(int length, int target, int oddPart);
+      static int colour(const Coordinates& c) { return (c.x() + c.y()) & 1; }
+
+      // door i is the entry of region 0 (i = 0), between regions i-1 and i, or the exit of the last region (i = #regions)
+      void chooseDoor(int i);
+      // generates all regions that are not done yet, returns false if some failed
+      bool generateRegions();
+      // path covers the board, respects the walls and uses only the doors between regions
+      bool verify(const Board& board, const Path& path) const;
+
+    private:
+      int m_width;
+      int m_height;
+      unsigned int m_seed;
+      int m_regionSize;
+      unsigned int m_threads;
+      LearnedClauseCache* m_learnedClauses = nullptr;
+      Encoding m_encoding = Encoding::Pairwise;
+      BackboneCache* m_backbones = nullptr;
+      std::mt19937 m_rng;
+      int m_inColour = 0;
+      std::vector<Region> m_regions;
+      Path m_solution;
+      GeneratorStats m_stats;
+};
@@ -0,0 +1,62 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <chrono>
+
+#include "satSolver.h"
+#include "trace.h"
+
+#ifdef ALCAZAR_SAT_IPASIR
+#include "ipasirSolver.h"
+#else
+#include "mergesatSolver.h"
+#endif
+
+
+std::unique_ptr<SatSolver> SatSolver::create()
+{
+#ifdef ALCAZAR_SAT_IPASIR
+    return std::unique_ptr<SatSolver>(new IpasirSolver);
+#else
+    return std::unique_ptr<SatSolver>(new MergesatSolver);
+#endif
+}
+
+
+bool SatSolver::solve(const std::vector<Lit>& assumptions)
+{
+    Trace& trace = Trace::instance();
+    if (!trace.enabled())
+    {
+        return run(assumptions);
+    }
+    
+    const uint64_t conflictsBefore = conflicts();
+    const auto start = std::chrono::steady_clock::now();
+    const bool result = run(assumptions);
+    const auto end = std::chrono::steady_clock::now();
+    trace.addSolve(m_phase, assumptions.size(), result ? "sat" : (interrupted() ? "interrupted" : "unsat"), conflicts() - conflictsBefore, start, end);
+    return result;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Literal of a SAT backend, encoded like Minisat's (2 * variable + sign), so
+// that toInt() yields a dense index.
+class Lit
+{
+    public:
+        Lit() = default;
+        Lit(int var, bool sign) : m_x(var + var + (sign ? 1 : 0)) {}
+        
+        int var() const { return m_x >> 1; }
+        bool sign() const { return (m_x & 1) != 0; }
+        int toInt() const { return m_x; }
+        bool isUndefined() const { return m_x < 0; }
+        
+        Lit operator~() const { Lit l; l.m_x = m_x ^ 1; return l; }
+    
+    private:
+        int m_x = -2;
+};
+
+inline Lit mkLit(int var, bool sign = false) { return Lit(var, sign); }
+inline int toInt(const Lit& lit) { return lit.toInt(); }
+
+inline bool operator==(const Lit& left, const Lit& right) { return left.toInt() == right.toInt(); }
+inline bool operator!=(const Lit& left, const Lit& right) { return left.toInt() != right.toInt(); }
+inline bool operator<(const Lit& left, const Lit& right) { return left.toInt() < right.toInt(); }
+
+
+// Incremental SAT solver as used by the generator: clauses, solving under
+// assumptions, model, final conflict and asynchronous interrupt.
+// The backend is selected at build time (see SAT_BACKEND in CMakeLists.txt).
+class SatSolver
+{
+    public:
+        virtual ~SatSolver() = default;
+        
+        static std::unique_ptr<SatSolver> create();
+        
+        virtual std::string name() const = 0;
+        
+        virtual int newVar() = 0;
+        virtual int nVars() const = 0;
+        virtual int nClauses() const = 0;
+        
+        void addClause(Lit a) { addClause(std::vector<Lit>{a}); }
+        void addClause(Lit a, Lit b) { addClause(std::vector<Lit>{a, b}); }
+        void addClause(Lit a, Lit b, Lit c) { addClause(std::vector<Lit>{a, b, c}); }
+        void addClause(const std::vector<Lit>& clause) { add(clause); }
+        
+        // true if satisfiable under the assumptions; false if unsatisfiable
+        // *or* interrupted, so callers that interrupt have to check interrupted()
+        bool solve(const std::vector<Lit>& assumptions);
+        virtual bool interrupted() const = 0;
+        // total number of conflicts so far (0 if the backend does not report them)
+        virtual uint64_t conflicts() const = 0;
+        
+        // label of the following solve calls in the trace (see --trace)
+        void setPhase(const std::string& phase) { m_phase = phase; }
+        
+        // may be called from another thread; stays in effect until clearInterrupt()
+        virtual void interrupt() = 0;
+        virtual void clearInterrupt() = 0;
+        
+        // value of the literal in the model of the last satisfiable solve
+        virtual bool modelValue(Lit lit) const = 0;
+        // negated failed assumptions of the last unsatisfiable solve (like Minisat's conflict)
+        virtual const std::vector<Lit>& conflict() const = 0;
+        
+        // keep learned clauses of at most maxLength literals (and LBD at most maxLbd, if the backend tracks it)
+        // from now on, maxLength = 0 stops; takeLearnedClauses() returns the kept clauses (including learned units).
+        // Learned clauses are implied by the clauses added so far, whatever the assumptions were.
+        // Backends collecting clauses while solving may skip those with variables created after the call.
+        // Backends without access to their learned clauses return none.
+        virtual void keepLearnedClauses(int /*maxLength*/, int /*maxLbd*/) {}
+        virtual std::vector<std::vector<Lit>> takeLearnedClauses() { return {}; }
+    
+    protected:
+        virtual void add(const std::vector<Lit>& clause) = 0;
+        virtual bool run(const std::vector<Lit>& assumptions) = 0;
+    
+    private:
+        std::string m_phase = "solve";
+};
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "scheduler.h"
+
+namespace
+{
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+        double load = 0.0;
+    };
+}
+
+
+std::size_t runScheduled(const std::vector<double>& costs, unsigned int threads, const std::function<void(std::size_t task)>& run)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned int>(threads, std::max<std::size_t>(costs.size(), 1));
+    
+    std::vector<std::size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&costs](std::size_t a, std::size_t b) { return costs[a] > costs[b]; });
+    
+    std::vector<WorkerQueue> queues(threads);
+    for (auto task: order)
+    {
+        WorkerQueue& least = *std::min_element(queues.begin(), queues.end(), [](const WorkerQueue& a, const WorkerQueue& b) { return a.load < b.load; });
+        least.tasks.push_back(task);
+        least.load += costs[task];
+    }
+    
+    auto take = [&costs](WorkerQueue& queue, std::size_t& task)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        queue.load -= costs[task];
+        return true;
+    };
+    
+    std::atomic<std::size_t> steals(0);
+    auto worker = [&](unsigned int self)
+    {
+        std::size_t task = 0;
+        for (;;)
+        {
+            if (!take(queues[self], task))
+            {
+                WorkerQueue* victim = nullptr;
+                double victimLoad = 0.0;
+                for (auto& queue: queues)
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (!queue.tasks.empty() && (victim == nullptr || queue.load > victimLoad))
+                    {
+                        victim = &queue;
+                        victimLoad = queue.load;
+                    }
+                }
+                if (victim == nullptr)
+                {
+                    // no task is left anywhere (none is added while running)
+                    return;
+                }
+                if (!take(*victim, task))
+                {
+                    continue;
+                }
+                ++steals;
+            }
+            run(task);
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back(worker, t);
+    }
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+    return steals;
+}
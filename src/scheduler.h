@@ -0,0 +1,39 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Runs the tasks 0 .. costs.size()-1 on a pool of worker threads (0 = one per
+// hardware thread) with the given expected costs. The tasks are dealt to
+// per-worker queues longest first, each to the worker with the least expected
+// load; a worker takes the front of its own queue and, once that is empty,
+// steals the front of the queue with the most expected load left, so a
+// misestimated straggler only delays the tasks queued behind it until another
+// worker gets idle. Returns the number of stolen tasks.
+std::size_t runScheduled(const std::vector<double>& costs, unsigned int threads, const std::function<void(std::size_t task)>& run);
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include "symmetry.h"
+
+namespace
+{
+    // maps a grid point (wall intersection) of a board with the given extents
+    Coordinates transformPoint(const Coordinates& p, Transform t, int width, int height)
+    {
+        switch (t)
+        {
+            case Transform::Identity:      return p;
+            case Transform::Rotate90:      return {height - p.y(), p.x()};
+            case Transform::Rotate180:     return {width - p.x(), height - p.y()};
+            case Transform::Rotate270:     return {p.y(), width - p.x()};
+            case Transform::MirrorX:       return {width - p.x(), p.y()};
+            case Transform::MirrorY:       return {p.x(), height - p.y()};
+            case Transform::Transpose:     return {p.y(), p.x()};
+            case Transform::AntiTranspose: return {height - p.y(), width - p.x()};
+        }
+        return p;
+    }
+}
+
+
+std::vector<Transform> validTransforms(int width, int height)
+{
+    std::vector<Transform> transforms{Transform::Identity, Transform::Rotate180, Transform::MirrorX, Transform::MirrorY};
+    if (width == height)
+    {
+        transforms.push_back(Transform::Rotate90);
+        transforms.push_back(Transform::Rotate270);
+        transforms.push_back(Transform::Transpose);
+        transforms.push_back(Transform::AntiTranspose);
+    }
+    return transforms;
+}
+
+
+Transform inverse(Transform t)
+{
+    switch (t)
+    {
+        case Transform::Rotate90:  return Transform::Rotate270;
+        case Transform::Rotate270: return Transform::Rotate90;
+        default:                   return t;
+    }
+}
+
+
+bool swapsAxes(Transform t)
+{
+    return t == Transform::Rotate90 || t == Transform::Rotate270 || t == Transform::Transpose || t == Transform::AntiTranspose;
+}
+
+
+Coordinates transform(const Coordinates& field, Transform t, int width, int height)
+{
+    // a field is the unit square between two diagonal grid points
+    const Coordinates p1 = transformPoint(field, t, width, height);
+    const Coordinates p2 = transformPoint(field.offset(1, 1), t, width, height);
+    return {std::min(p1.x(), p2.x()), std::min(p1.y(), p2.y())};
+}
+
+
+Wall transform(const Wall& wall, Transform t, int width, int height)
+{
+    // a wall is the unit segment between two grid points
+    const Coordinates& c = wall.m_coordinates;
+    const Coordinates p1 = transformPoint(c, t, width, height);
+    const Coordinates p2 = transformPoint(wall.m_orientation == Orientation::H ? c.offset(1, 0) : c.offset(0, 1), t, width, height);
+    const Coordinates p(std::min(p1.x(), p2.x()), std::min(p1.y(), p2.y()));
+    return Wall(p, p1.x() == p2.x() ? Orientation::V : Orientation::H);
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include "coordinates.h"
+#include "wall.h"
+
+// the dihedral transformations of a width x height board; the ones that swap
+// the axes (quarter turns and transpositions) are only valid for square boards
+enum class Transform
+{
+    Identity,
+    Rotate90,
+    Rotate180,
+    Rotate270,
+    MirrorX,
+    MirrorY,
+    Transpose,
+    AntiTranspose
+};
+
+std::vector<Transform> validTransforms(int width, int height);
+Transform inverse(Transform t);
+bool swapsAxes(Transform t);
+
+Coordinates transform(const Coordinates& field, Transform t, int width, int height);
+Wall transform(const Wall& wall, Transform t, int width, int height);
@@ -13,6 +13,8 @@
  ************************************************/
 
 #include "templateBoard.h"
+#include "geometry.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -38,6 +40,22 @@ TemplateBoard::TemplateBoard(int w, int h) :
 }
 
 
+void TemplateBoard::setFixedClosed(const Wall& w)
+{
+    m_possibleWalls.erase(w);
+    m_fixedOpenWalls.erase(w);
+    m_fixedClosedWalls.insert(w);
+}
+
+
+void TemplateBoard::setFixedOpen(const Wall& w)
+{
+    m_possibleWalls.erase(w);
+    m_fixedClosedWalls.erase(w);
+    m_fixedOpenWalls.insert(w);
+}
+
+
 enum class WallType
 {
     FixedClosed,
@@ -68,16 +86,45 @@ std::vector<WallType> filter(const std::string& s)
 }
 
 
+// fields marked as holes ('#' between two wall characters of a field line)
+std::vector<bool> filterHoles(const std::string& s)
+{
+    std::vector<bool> res;
+    int walls = 0;
+    for (auto c: s)
+    {
+        if (c == '|' || c == '/' || c == '?')
+        {
+            ++walls;
+        }
+        else if (c == '#' && walls > 0)
+        {
+            res.resize(walls, false);
+            res[walls - 1] = true;
+        }
+    }
+    return res;
+}
+
+
+int TemplateBoard::fieldCount() const
+{
+    return m_width * m_height - static_cast<int>(std::count(m_holes.begin(), m_holes.end(), true));
+}
+
+
 bool TemplateBoard::parse(std::istream& is)
 {
     m_width = 0;
     m_height = 0;
+    m_holes.clear();
     m_allWalls.clear();
     m_possibleWalls.clear();
     m_fixedClosedWalls.clear();
     m_fixedOpenWalls.clear();
 
     std::vector<std::vector<WallType>> lines;
+    std::vector<std::vector<bool>> holeLines;
     std::string s;
     unsigned int w = 0;
     while (std::getline(is, s))
@@ -85,6 +132,7 @@ bool TemplateBoard::parse(std::istream& is)
         // -,|  =>  fixed closed wall
         // /    =>  fixed open wall
         // ?    =>  possible wall
+        // #    =>  hole (in place of a field)
 
         if (s.empty())
         {
@@ -125,6 +173,7 @@ bool TemplateBoard::parse(std::istream& is)
         }
 
         lines.push_back(walls);
+        holeLines.push_back(filterHoles(s));
     }
 
     if (lines.empty() || lines.size() < 5 || (lines.size() & 1) == 0)
@@ -135,6 +184,25 @@ bool TemplateBoard::parse(std::istream& is)
     m_width = w;
     m_height = static_cast<int>(lines.size() - 1)/2;
 
+    for (int y = 0; y < m_height; ++y)
+    {
+        const auto& line = holeLines[2 * y + 1];
+        for (int x = 0; x < std::min<int>(m_width, line.size()); ++x)
+        {
+            if (line[x])
+            {
+                m_holes.resize(m_width * m_height, false);
+                m_holes[x + m_width * y] = true;
+            }
+        }
+    }
+    if (fieldCount() < 2)
+    {
+        return false;
+    }
+    // walls with no field on either side do not exist
+    auto present = [this](int x, int y) { return x >= 0 && y >= 0 && x < m_width && y < m_height && !isHole({x, y}); };
+
     for (unsigned int row = 0; row < lines.size(); ++row)
     {
         const auto& line = lines[row];
@@ -145,6 +213,10 @@ bool TemplateBoard::parse(std::istream& is)
             for (unsigned int x = 0; x < line.size(); ++x)
             {
                 const Wall wall({static_cast<int>(x), static_cast<int>(y)}, Orientation::H);
+                if (!present(x, static_cast<int>(y) - 1) && !present(x, y))
+                {
+                    continue;
+                }
                 m_allWalls.insert(wall);
                 switch (line[x])
                 {
@@ -167,6 +239,10 @@ bool TemplateBoard::parse(std::istream& is)
             for (unsigned int x = 0; x < line.size(); ++x)
             {
                 const Wall wall({static_cast<int>(x), static_cast<int>(y)}, Orientation::V);
+                if (!present(static_cast<int>(x) - 1, y) && !present(x, y))
+                {
+                    continue;
+                }
                 m_allWalls.insert(wall);
                 switch (line[x])
                 {
@@ -195,36 +271,119 @@ std::vector<Coordinates> TemplateBoard::getNonBlockedEdgeFields() const
         return {};
     }
 
-    std::vector<Coordinates> edgeFields;
-
+    // top/bottom, left/right, the corners, then fields next to holes
+    std::vector<Coordinates> candidates;
     for (int x = 1; x + 1 < m_width; ++x)
     {
-        // top
-        if (!isClosed(Wall({x, 0}, Orientation::H))) edgeFields.push_back({x, 0});
-        // bottom
-        if (!isClosed(Wall({x, m_height}, Orientation::H))) edgeFields.push_back({x, m_height - 1});
+        candidates.push_back({x, 0});
+        candidates.push_back({x, m_height - 1});
     }
     for (int y = 1; y + 1 < m_height; ++y)
     {
-        // left
-        if (!isClosed(Wall({0, y}, Orientation::V))) edgeFields.push_back({0, y});
-        // right
-        if (!isClosed(Wall({m_width, y}, Orientation::V))) edgeFields.push_back({m_width - 1, y});
+        candidates.push_back({0, y});
+        candidates.push_back({m_width - 1, y});
+    }
+    candidates.push_back({0, 0});
+    candidates.push_back({m_width - 1, 0});
+    candidates.push_back({0, m_height - 1});
+    candidates.push_back({m_width - 1, m_height - 1});
+    if (!m_holes.empty())
+    {
+        for (int y = 1; y + 1 < m_height; ++y)
+        {
+            for (int x = 1; x + 1 < m_width; ++x)
+            {
+                candidates.push_back({x, y});
+            }
+        }
+    }
+
+    // an edge field is blocked if all of its border walls are closed
+    const Geometry geometry(m_width, m_height, m_holes);
+    std::vector<Coordinates> edgeFields;
+    for (auto c: candidates)
+    {
+        if (isHole(c))
+        {
+            continue;
+        }
+        const std::vector<Wall> walls = borderWalls(geometry, geometry.c2f(c));
+        if (std::any_of(walls.begin(), walls.end(), [this](const Wall& w) { return !isClosed(w); }))
+        {
+            edgeFields.push_back(c);
+        }
     }
 
-    // top left
-    if (!isClosed(Wall({0, 0}, Orientation::H)) || !isClosed(Wall({0, 0}, Orientation::V))) edgeFields.push_back({0, 0});
+    return edgeFields;
+}
 
-    // top right
-    if (!isClosed(Wall({m_width - 1, 0}, Orientation::H)) || !isClosed(Wall({m_width, 0}, Orientation::V))) edgeFields.push_back({m_width - 1, 0});
 
-    // bottom left
-    if (!isClosed(Wall({0, m_height}, Orientation::H)) || !isClosed(Wall({0, m_height - 1}, Orientation::V))) edgeFields.push_back({0, m_height - 1});
+uint64_t TemplateBoard::hash() const
+{
+    // FNV-1a over the dimensions and the classified wall positions
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](int value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            h ^= static_cast<uint64_t>((value >> (8 * i)) & 0xff);
+            h *= 1099511628211ull;
+        }
+    };
 
-    // bottom right
-    if (!isClosed(Wall({m_width - 1, m_height}, Orientation::H)) || !isClosed(Wall({m_width, m_height - 1}, Orientation::V))) edgeFields.push_back({m_width - 1, m_height - 1});
+    mix(m_width);
+    mix(m_height);
+    for (int field = 0; field < static_cast<int>(m_holes.size()); ++field)
+    {
+        if (m_holes[field]) mix(-4 - field);
+    }
+    int tag = 0;
+    for (auto walls: {&m_fixedClosedWalls, &m_fixedOpenWalls, &m_possibleWalls})
+    {
+        mix(--tag);
+        for (auto wall: *walls)
+        {
+            mix(wall.m_coordinates.x());
+            mix(wall.m_coordinates.y());
+            mix(wall.m_orientation == Orientation::H ? 0 : 1);
+        }
+    }
+    return h;
+}
 
-    return edgeFields;
+
+std::vector<Transform> TemplateBoard::getSymmetries() const
+{
+    std::vector<Transform> symmetries;
+    for (auto t: validTransforms(m_width, m_height))
+    {
+        if (t == Transform::Identity) continue;
+
+        bool symmetric = true;
+        for (int y = 0; y < m_height && symmetric; ++y)
+        {
+            for (int x = 0; x < m_width && symmetric; ++x)
+            {
+                symmetric = !isHole({x, y}) || isHole(transform(Coordinates(x, y), t, m_width, m_height));
+            }
+        }
+        for (auto walls: {&m_fixedClosedWalls, &m_fixedOpenWalls, &m_possibleWalls})
+        {
+            for (auto wall: *walls)
+            {
+                if (walls->find(transform(wall, t, m_width, m_height)) == walls->end())
+                {
+                    symmetric = false;
+                    break;
+                }
+            }
+        }
+        if (symmetric)
+        {
+            symmetries.push_back(t);
+        }
+    }
+    return symmetries;
 }
 
 
@@ -253,6 +412,11 @@ std::ostream& operator<<(std::ostream& os, const TemplateBoard& b)
             grid[gy+0][gx+dx]  = '+';
             grid[gy+dy][gx+0]  = '+';
             grid[gy+dy][gx+dx] = '+';
+
+            if (b.isHole({x, y}))
+            {
+                for (int i = 1; i < dx; ++i) grid[gy + dy/2][gx+i] = '#';
+            }
         }
     }
 
@@ -15,7 +15,9 @@
 #pragma once
 
 #include "coordinates.h"
+#include "symmetry.h"
 #include "wall.h"
+#include <cstdint>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -29,12 +31,24 @@ class TemplateBoard
         bool empty() const { return m_width == 0 || m_height == 0; }
         int width() const { return m_width; }
         int height() const { return m_height; }
+        // fields cut out of the board ('#' in a template), one flag per field, empty if there are none
+        const std::vector<bool>& getHoles() const { return m_holes; }
+        bool isHole(const Coordinates& c) const { return !m_holes.empty() && m_holes[c.x() + m_width * c.y()]; }
+        // number of fields without the holes, i.e. the path length
+        int fieldCount() const;
 
         const std::set<Wall>& getAllWalls() const { return m_allWalls; }
         const std::set<Wall>& getPossibleWalls() const { return m_possibleWalls; }
         const std::set<Wall>& getFixedClosedWalls() const { return m_fixedClosedWalls; }
         const std::set<Wall>& getFixedOpenWalls() const { return m_fixedOpenWalls; }
         std::vector<Coordinates> getNonBlockedEdgeFields() const;
+        uint64_t hash() const;
+        // non-identity transforms mapping every wall class onto itself
+        std::vector<Transform> getSymmetries() const;
+
+        // change the type of a single wall position
+        void setFixedClosed(const Wall& w);
+        void setFixedOpen(const Wall& w);
 
         bool parse(std::istream& is);
 
@@ -43,6 +57,7 @@ class TemplateBoard
 
         int m_width = 0;
         int m_height = 0;
+        std::vector<bool> m_holes;
         std::set<Wall> m_allWalls;
         std::set<Wall> m_fixedClosedWalls;
         std::set<Wall> m_fixedOpenWalls;
@@ -0,0 +1,219 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "templateCheck.h"
+
+namespace
+{
+    std::string fieldName(int field, int width)
+    {
+        std::ostringstream s;
+        s << "field (" << field % width << ", " << field / width << ")";
+        return s.str();
+    }
+    
+    // component labels of the graph without 'removed' and the holes (-1 for those); returns the number of components
+    int components(const std::vector<std::vector<int>>& neighbours, const std::vector<bool>& holes, int removed, std::vector<int>& label)
+    {
+        label.assign(neighbours.size(), -1);
+        int count = 0;
+        std::vector<int> stack;
+        for (int start = 0; start < static_cast<int>(neighbours.size()); ++start)
+        {
+            if (start == removed || (!holes.empty() && holes[start]) || label[start] != -1)
+            {
+                continue;
+            }
+            label[start] = count;
+            stack.push_back(start);
+            while (!stack.empty())
+            {
+                const int field = stack.back();
+                stack.pop_back();
+                for (auto n: neighbours[field])
+                {
+                    if (n != removed && label[n] == -1)
+                    {
+                        label[n] = count;
+                        stack.push_back(n);
+                    }
+                }
+            }
+            ++count;
+        }
+        return count;
+    }
+}
+
+
+bool checkTemplate(const TemplateBoard& templateBoard, std::vector<std::pair<int, int>>& pairs, std::string& reason)
+{
+    pairs.clear();
+    reason.clear();
+    
+    const int width = templateBoard.width();
+    const int height = templateBoard.height();
+    const int fields = width * height;
+    const std::set<Wall>& closed = templateBoard.getFixedClosedWalls();
+    const std::vector<bool>& holes = templateBoard.getHoles();
+    
+    std::vector<std::vector<int>> neighbours(fields);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const int field = x + width * y;
+            if (templateBoard.isHole({x, y}))
+            {
+                continue;
+            }
+            if (x + 1 < width && !templateBoard.isHole({x + 1, y}) && closed.find(Wall({x + 1, y}, Orientation::V)) == closed.end())
+            {
+                neighbours[field].push_back(field + 1);
+                neighbours[field + 1].push_back(field);
+            }
+            if (y + 1 < height && !templateBoard.isHole({x, y + 1}) && closed.find(Wall({x, y + 1}, Orientation::H)) == closed.end())
+            {
+                neighbours[field].push_back(field + width);
+                neighbours[field + width].push_back(field);
+            }
+        }
+    }
+    
+    std::vector<bool> isEdge(fields, false);
+    for (auto c: templateBoard.getNonBlockedEdgeFields())
+    {
+        isEdge[c.x() + width * c.y()] = true;
+    }
+    
+    // connectivity
+    std::vector<int> label;
+    if (components(neighbours, holes, -1, label) != 1)
+    {
+        reason = "the fields are not connected";
+        return false;
+    }
+    
+    // fields with a single open side are end points
+    std::vector<int> forced;
+    for (int field = 0; field < fields; ++field)
+    {
+        if (!holes.empty() && holes[field])
+        {
+            continue;
+        }
+        if (neighbours[field].size() == 1)
+        {
+            if (!isEdge[field])
+            {
+                reason = fieldName(field, width) + " is a dead end";
+                return false;
+            }
+            forced.push_back(field);
+        }
+    }
+    if (forced.size() > 2)
+    {
+        reason = "more than 2 dead end fields";
+        return false;
+    }
+    
+    // checkerboard colours: a path alternates colours, so it starts and ends on different
+    // colours if both are equally frequent, on the majority colour if it has one field more
+    auto colour = [width](int field) { return (field % width + field / width) & 1; };
+    int colourCount[2] = {0, 0};
+    for (int field = 0; field < fields; ++field)
+    {
+        if (holes.empty() || !holes[field])
+        {
+            ++colourCount[colour(field)];
+        }
+    }
+    if (std::abs(colourCount[0] - colourCount[1]) > 1)
+    {
+        reason = "the checkerboard colours differ by more than 1 field";
+        return false;
+    }
+    const int majority = (colourCount[0] > colourCount[1]) ? 0 : 1;
+    
+    for (int entry = 0; entry < fields; ++entry)
+    {
+        if (!isEdge[entry])
+        {
+            continue;
+        }
+        for (int exit = entry + 1; exit < fields; ++exit)
+        {
+            if (!isEdge[exit])
+            {
+                continue;
+            }
+            if ((colourCount[0] == colourCount[1]) ? (colour(entry) == colour(exit)) : (colour(entry) != majority || colour(exit) != majority))
+            {
+                continue;
+            }
+            if (std::any_of(forced.begin(), forced.end(), [entry, exit](int f) { return f != entry && f != exit; }))
+            {
+                continue;
+            }
+            pairs.push_back({entry, exit});
+        }
+    }
+    if (pairs.empty())
+    {
+        reason = "no pair of open edge fields fits the checkerboard colouring";
+        return false;
+    }
+    
+    // an articulation point is passed once, so it can join only 2 parts, and both end points have to lie in different ones
+    for (int field = 0; field < fields && !pairs.empty(); ++field)
+    {
+        const int count = components(neighbours, holes, field, label);
+        if (count == 1)
+        {
+            continue;
+        }
+        if (count > 2)
+        {
+            reason = fieldName(field, width) + " separates the board into " + std::to_string(count) + " parts";
+            return false;
+        }
+        pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [&label](const std::pair<int, int>& p)
+            {
+                return label[p.first] == -1 || label[p.second] == -1 || label[p.first] == label[p.second];
+            }), pairs.end());
+    }
+    if (pairs.empty())
+    {
+        reason = "no pair of open edge fields is separated by all articulation points";
+        return false;
+    }
+    
+    return true;
+}
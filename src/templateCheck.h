@@ -0,0 +1,42 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "templateBoard.h"
+
+// Structural pre-check of a template without any SAT solving. Works on the
+// graph of fields connected by walls that are not fixed closed and uses
+// necessary conditions for a Hamiltonian path between two open edge fields:
+// connectivity, fields with a single open side (which have to be end points),
+// checkerboard colour balance, and articulation points (which have to separate
+// the two end points).
+// On success 'pairs' holds the remaining (entry, exit) candidates as field
+// indices x + width * y with entry < exit; otherwise 'reason' says why the
+// template cannot have a solution.
+bool checkTemplate(const TemplateBoard& templateBoard, std::vector<std::pair<int, int>>& pairs, std::string& reason);
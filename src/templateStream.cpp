@@ -0,0 +1,114 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <sstream>
+
+#include "templateStream.h"
+
+
+bool TemplateStream::next(TemplateEntry& entry)
+{
+    entry = TemplateEntry();
+    entry.index = m_index;
+    entry.line = m_headerLine + 1;
+    
+    std::ostringstream body;
+    bool hasBody = false;
+    bool hasSeparator = false;
+    std::string s;
+    while (std::getline(m_is, s))
+    {
+        ++m_line;
+        if (!s.empty() && s[0] == '%')
+        {
+            if (hasBody)
+            {
+                hasSeparator = true;
+                break;
+            }
+            // leading or repeated separators: the last one applies
+            m_header = s;
+            m_headerLine = m_line;
+            entry.line = m_line + 1;
+            continue;
+        }
+        if (s.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            hasBody = true;
+        }
+        body << s << '\n';
+    }
+    
+    if (!hasBody)
+    {
+        return false;
+    }
+    
+    std::istringstream is(body.str());
+    entry.valid = parseSettings(m_header, entry) && entry.board.parse(is);
+    
+    // the separator that ended this template belongs to the next one
+    m_header = hasSeparator ? s : std::string();
+    m_headerLine = m_line;
+    ++m_index;
+    return true;
+}
+
+
+bool TemplateStream::parseSettings(const std::string& s, TemplateEntry& entry) const
+{
+    std::istringstream is(s.empty() ? s : s.substr(1));
+    std::string setting;
+    while (is >> setting)
+    {
+        const auto pos = setting.find('=');
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+        const std::string key = setting.substr(0, pos);
+        std::istringstream value(setting.substr(pos + 1));
+        if (key == "count")
+        {
+            if (!(value >> entry.count) || entry.count < 1)
+            {
+                return false;
+            }
+        }
+        else if (key == "seed")
+        {
+            if (!(value >> entry.seed))
+            {
+                return false;
+            }
+            entry.hasSeed = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include "templateBoard.h"
+
+struct TemplateEntry
+{
+    TemplateBoard board;
+    int index = 0;
+    int line = 0;      // first line of the template in the stream
+    bool valid = false;
+    int count = 0;     // 0 = not specified
+    unsigned int seed = 0;
+    bool hasSeed = false;
+};
+
+// Reads a sequence of templates from a stream. Templates are separated by
+// lines starting with '%', which may carry settings for the following
+// template, e.g. "% count=3 seed=42". A stream without separators is a
+// single template, so plain template files work unchanged.
+class TemplateStream
+{
+    public:
+        explicit TemplateStream(std::istream& is) : m_is(is) {}
+        
+        // false at the end of the stream; entry.valid is false for syntax errors
+        bool next(TemplateEntry& entry);
+    
+    private:
+        bool parseSettings(const std::string& s, TemplateEntry& entry) const;
+        
+        std::istream& m_is;
+        int m_index = 0;
+        int m_line = 0;
+        std::string m_header;
+        int m_headerLine = 0;
+};
@@ -0,0 +1,90 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <fstream>
+
+#include "trace.h"
+
+
+Trace& Trace::instance()
+{
+    static Trace trace;
+    return trace;
+}
+
+
+void Trace::enable()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_origin = std::chrono::steady_clock::now();
+    m_mainThread = std::this_thread::get_id();
+    m_tracks[m_mainThread] = 0;
+    m_enabled = true;
+}
+
+
+int64_t Trace::microseconds(std::chrono::steady_clock::time_point t) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - m_origin).count();
+}
+
+
+void Trace::addSolve(const std::string& phase, std::size_t assumptions, const char* result, uint64_t conflicts,
+    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // tracks are numbered in order of the first solve call of each thread
+    const auto track = m_tracks.insert({std::this_thread::get_id(), m_tracks.size()}).first->second;
+    m_events.push_back({phase, assumptions, result, conflicts, microseconds(start), microseconds(end) - microseconds(start), track});
+}
+
+
+bool Trace::write(const std::string& fileName) const
+{
+    std::ofstream f(fileName);
+    if (!f)
+    {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    f << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    f << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"alcazar-gen\"}}";
+    for (const auto& track: m_tracks)
+    {
+        const std::string name = (track.second == 0) ? "main" : "worker " + std::to_string(track.second);
+        f << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << track.second << ", \"args\": {\"name\": \"" << name << "\"}}";
+        f << ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << track.second << ", \"args\": {\"sort_index\": " << track.second << "}}";
+    }
+    for (const auto& e: m_events)
+    {
+        f << ",\n{\"name\": \"" << e.phase << "\", \"cat\": \"solve\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.track
+          << ", \"ts\": " << e.start << ", \"dur\": " << e.duration
+          << ", \"args\": {\"assumptions\": " << e.assumptions << ", \"result\": \"" << e.result << "\", \"conflicts\": " << e.conflicts << "}}";
+    }
+    f << "\n]}\n";
+    
+    return static_cast<bool>(f);
+}
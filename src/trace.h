@@ -0,0 +1,77 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Timeline of all SAT solver calls of a run in Chrome's trace event format
+// (load the file in chrome://tracing or ui.perfetto.dev). Every solve call is
+// one complete event on the track of the calling thread, with phase, number
+// of assumptions, result and conflicts as arguments.
+//
+// Recording is off unless enabled; then adding events is thread-safe.
+class Trace
+{
+    public:
+        static Trace& instance();
+        
+        void enable();
+        bool enabled() const { return m_enabled; }
+        
+        void addSolve(const std::string& phase, std::size_t assumptions, const char* result, uint64_t conflicts,
+            std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+        
+        bool write(const std::string& fileName) const;
+    
+    private:
+        struct Event
+        {
+            std::string phase;
+            std::size_t assumptions;
+            const char* result;
+            uint64_t conflicts;
+            int64_t start;
+            int64_t duration;
+            int track;
+        };
+        
+        Trace() = default;
+        int64_t microseconds(std::chrono::steady_clock::time_point t) const;
+        
+        std::atomic<bool> m_enabled{false};
+        std::chrono::steady_clock::time_point m_origin;
+        std::thread::id m_mainThread;
+        mutable std::mutex m_mutex;
+        std::map<std::thread::id, int> m_tracks;
+        std::vector<Event> m_events;
+};
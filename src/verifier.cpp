@@ -0,0 +1,198 @@
+/*******************************************************************************
+* alcazar-gen
+*
+* Copyright (c) 2015 Florian Pigorsch
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*******************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "puzzleDatabase.h"
+#include "verifier.h"
+
+namespace
+{
+    struct Puzzle
+    {
+        std::string name;
+        Board board;
+        Path solution;
+    };
+    
+    enum class Verdict
+    {
+        Unique,
+        NotUnique,
+        NotSolvable,
+        SolutionMismatch
+    };
+    
+    bool loadPuzzles(const std::string& fileName, std::vector<Puzzle>& puzzles)
+    {
+        if (PuzzleDatabase::isDatabase(fileName))
+        {
+            PuzzleDatabase db;
+            if (!db.open(fileName))
+            {
+                std::cout << "Error: cannot open puzzle database '" << fileName << "'" << std::endl;
+                return false;
+            }
+            for (uint64_t i = 0; i < db.size(); ++i)
+            {
+                const PuzzleRecord record = db.get(i);
+                if (record.board.width() == 0)
+                {
+                    std::cout << "Error: puzzle database '" << fileName << "' is corrupt at record #" << i << std::endl;
+                    return false;
+                }
+                puzzles.push_back({fileName + "#" + std::to_string(i), record.board, record.solution});
+            }
+            return true;
+        }
+        
+        std::ifstream file(fileName);
+        if (!file)
+        {
+            std::cout << "Error: cannot open '" << fileName << "' for reading" << std::endl;
+            return false;
+        }
+        Puzzle puzzle;
+        int line = 0;
+        std::string error;
+        for (int i = 0; ; ++i)
+        {
+            if (!puzzle.board.parse(file, puzzle.solution, &line, &error))
+            {
+                if (error.empty())
+                {
+                    break;
+                }
+                // stopping here would silently drop every following puzzle
+                std::cout << "Error: '" << fileName << "' line " << line << ": " << error << std::endl;
+                return false;
+            }
+            puzzle.name = fileName + "#" + std::to_string(i);
+            puzzles.push_back(puzzle);
+        }
+        return true;
+    }
+    
+    Verdict verify(const Puzzle& puzzle)
+    {
+        const std::tuple<bool, bool, Path> solution = puzzle.board.solve();
+        if (!std::get<0>(solution))
+        {
+            return Verdict::NotSolvable;
+        }
+        if (!std::get<1>(solution))
+        {
+            return Verdict::NotUnique;
+        }
+        // a stored solution (if any) has to be the unique one
+        if (!puzzle.solution.isEmpty() && !puzzle.solution.isEquivalent(std::get<2>(solution)))
+        {
+            return Verdict::SolutionMismatch;
+        }
+        return Verdict::Unique;
+    }
+}
+
+
+bool verifyPuzzles(const std::vector<std::string>& files, unsigned int threads)
+{
+    std::vector<Puzzle> puzzles;
+    for (const auto& fileName: files)
+    {
+        if (!loadPuzzles(fileName, puzzles))
+        {
+            return false;
+        }
+    }
+    
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned int>(threads, std::max<std::size_t>(puzzles.size(), 1));
+    std::cout << "Info: verifying " << puzzles.size() << " puzzles with " << threads << " threads" << std::endl;
+    
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<Verdict> verdicts(puzzles.size());
+    std::atomic<std::size_t> next(0);
+    std::size_t done = 0;
+    std::mutex mutex;
+    auto worker = [&]()
+    {
+        for (std::size_t i = next++; i < puzzles.size(); i = next++)
+        {
+            verdicts[i] = verify(puzzles[i]);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            std::cout << "\rInfo: verified " << ++done << " of " << puzzles.size() << "                     " << std::flush;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread: pool)
+    {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "\r                                                  \r";
+    
+    // verdicts in input order, so that the output of two runs can be diffed
+    unsigned int unique = 0;
+    for (std::size_t i = 0; i < puzzles.size(); ++i)
+    {
+        std::cout << puzzles[i].name << ": ";
+        switch (verdicts[i])
+        {
+            case Verdict::Unique:
+                ++unique;
+                std::cout << "uniquely solvable";
+                break;
+            case Verdict::NotUnique:
+                std::cout << "NOT uniquely solvable";
+                break;
+            case Verdict::NotSolvable:
+                std::cout << "NOT solvable";
+                break;
+            case Verdict::SolutionMismatch:
+                std::cout << "uniquely solvable, but NOT by the stored solution";
+                break;
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << "Info: " << unique << " of " << puzzles.size() << " puzzles are uniquely solvable; "
+        << seconds << "s, " << (seconds > 0 ? puzzles.size() / seconds : 0.0) << " puzzles/s" << std::endl;
+    return unique == puzzles.size();
+}
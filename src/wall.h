@@ -45,6 +45,12 @@ class Wall
 };
 
 
+inline bool operator==(const Wall& left, const Wall& right)
+{
+    return left.m_orientation == right.m_orientation && left.m_coordinates == right.m_coordinates;
+}
+
+
 inline bool operator<(const Wall& left, const Wall& right)
 {
     if (left.m_orientation != right.m_orientation)